@@ -0,0 +1,13 @@
+#ifndef SRC_COMPONENT_RANDOM_STATE_HPP
+#define SRC_COMPONENT_RANDOM_STATE_HPP
+
+#include <SDL3/SDL_stdinc.h>
+
+// Optional; when present, apple respawns draw from this state instead of the
+// global one behind SDL_rand(), so a game can be replayed from its seed.
+struct RandomState
+{
+    Uint64 state;
+}; // struct RandomState
+
+#endif // SRC_COMPONENT_RANDOM_STATE_HPP
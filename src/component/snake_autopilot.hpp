@@ -0,0 +1,15 @@
+#ifndef SRC_COMPONENT_SNAKE_AUTOPILOT_HPP
+#define SRC_COMPONENT_SNAKE_AUTOPILOT_HPP
+
+struct SnakeAutopilot
+{
+    enum Policy
+    {
+        SHORTEST_PATH,    // nearest apple, as long as the tail stays reachable
+        HAMILTONIAN_CYCLE // follow a cycle through every slot, cutting across it when safe
+    };
+    Policy policy = SHORTEST_PATH;
+    long decidedSlot = -1L; // slot of the snake head when KeyControl was last decided
+}; // struct SnakeAutopilot
+
+#endif // SRC_COMPONENT_SNAKE_AUTOPILOT_HPP
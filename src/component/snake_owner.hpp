@@ -0,0 +1,11 @@
+#ifndef SRC_COMPONENT_SNAKE_OWNER_HPP
+#define SRC_COMPONENT_SNAKE_OWNER_HPP
+
+#include <entt/entity/entity.hpp>
+
+struct SnakeOwner
+{
+    entt::entity head; // entity with the SnakePartHead this SnakePart belongs to
+}; // struct SnakeOwner
+
+#endif // SRC_COMPONENT_SNAKE_OWNER_HPP
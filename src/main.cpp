@@ -1,8 +1,11 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
-#include <string>
+#include <vector>
 
 #include <entt/entt.hpp>
-#include <sigslot/signal.hpp>
 #include <SDL3/SDL.h>
 
 #include <component/delta_time.hpp>
@@ -14,8 +17,14 @@
 #include <component/snake_part.hpp>
 #include <component/velocity.hpp>
 
+#include <system/command_buffer.hpp>
+#include <system/resource.hpp>
 #include <system/translate_2d.hpp>
 #include <system/snake_gameplay_system.hpp>
+#include <system/system_pipeline.hpp>
+#include <util/rolling_stats.hpp>
+#include <util/spsc_queue.hpp>
+#include <util/triple_buffer.hpp>
 
 #include "component/delta_time.hpp"
 #include "component/key_control.hpp"
@@ -25,9 +34,10 @@
 
 struct AppState
 {
-    Uint64 previousTick; // for FixedUpdate() equivalent
     SDL_Window *window = nullptr;
     SDL_Renderer *renderer = nullptr;
+    SDL_Thread *simulationThread = nullptr;
+    bool isFrameStale = false; // the frame must be drawn again, e.g. the window was exposed
 };
 
 namespace Global
@@ -39,7 +49,7 @@ namespace Global
     static constexpr float SPEED = 2.0f; // MUST BE >= 0.0f
     static constexpr float SPEED_UP_FACTOR = 5.0f;
     static constexpr float TICK_UNIT_TRAVELLED = 0.25f; // MUST BE <= 0.5f, see Nyquist-Shannon sampling theorem
-    static constexpr int MAP_WIDTH = 20;                // MUST BE >= 1
+    static constexpr int MAP_WIDTH = 20;                // MUST BE >= 3, see spawn_scene()
     static constexpr int MAP_HEIGHT = 20;               // MUST BE >= 1
 
     static constexpr float MAX_POSSIBLE_SPEED = SPEED * SPEED_UP_FACTOR;
@@ -47,11 +57,116 @@ namespace Global
 
     static constexpr Uint64 DESIRED_TICK_PERIOD_MS = static_cast<Uint64>(MAXIMUM_TICK_PERIOD_MS_FLOAT - 1.0f);
 
+    using SnakeGameplay = SnakeGameplaySystem::Fixed<MAP_WIDTH, MAP_HEIGHT>; // board size is known at compile time
+
+    using GameplayPipeline = SystemPipeline<SystemTranslate2D::iterate, SnakeGameplay::iterate, CommandBuffer::iterate>;
+
+    // Only the simulation thread touches these once it runs, see run_simulation().
     entt::registry reg;
-    sigslot::signal<entt::registry &> gameplayUpdateSig;
     bool isGamePaused = false;
+
+    // Timings over the last PERF_WINDOW frames, shown with F3. On the simulation
+    // thread a frame is one wake-up that ran ticks; catch-up ticks are those beyond the first.
+    static constexpr size_t PERF_WINDOW = 240U;
+    struct TickStats
+    {
+        RollingStats<PERF_WINDOW> tickMs;
+        RollingStats<PERF_WINDOW> ticksPerFrame;
+        RollingStats<PERF_WINDOW> catchUpTicks;
+        unsigned long catchUpTotal = 0UL;
+    }; // struct TickStats
+    TickStats tickStats; // simulation thread
+    struct RenderStats
+    {
+        RollingStats<PERF_WINDOW> renderMs;
+        RollingStats<PERF_WINDOW> presentMs;
+    }; // struct RenderStats
+    RenderStats renderStats; // main thread
+    std::atomic<bool> isPerfOverlayShown{false};
+
+    struct PercentileSummary
+    {
+        double p50 = 0.0;
+        double p99 = 0.0;
+        double max = 0.0;
+    }; // struct PercentileSummary
+
+    // What the main thread draws, copied out of the registry by the simulation thread.
+    struct Snapshot
+    {
+        std::vector<Uint8> slots; // row-major, width x height
+        long width = 0L;
+        long height = 0L;
+        Uint64 generation = 0U;
+        unsigned long score = 0UL;
+        SnakeGameplaySystem::GameStatus status = SnakeGameplaySystem::GameStatus::PLAYING;
+        bool isPaused = false;
+        size_t entityCount = 0U;
+        PercentileSummary tickMs; // these four only while the overlay is shown
+        PercentileSummary ticksPerFrame;
+        PercentileSummary catchUpTicks;
+        unsigned long catchUpTotal = 0UL;
+    }; // struct Snapshot
+    TripleBuffer<Snapshot> snapshots;
+    Uint32 snapshotEventType = 0U; // pushed after each snapshot, to wake the main thread
+
+    // Keys, passed from the main thread to the simulation thread.
+    enum InputCommand : Uint8
+    {
+        UP_KEY_DOWN,
+        LEFT_KEY_DOWN,
+        DOWN_KEY_DOWN,
+        RIGHT_KEY_DOWN,
+        SHIFT_KEY_DOWN,
+        SHIFT_KEY_UP,
+        TOGGLE_PAUSE,
+        RESTART,
+        PUBLISH_SNAPSHOT,
+    }; // enum InputCommand
+    SpscQueue<InputCommand, 64U> inputQueue;
+    SDL_Semaphore *inputSignal = nullptr; // signalled after each push, and to stop the simulation thread
+    std::atomic<bool> isSimulationStopping{false};
+
+    // The line under the board, drawn once into a texture and reused until what it says changes.
+    static constexpr int HUD_MAX_CHARS = 64;
+    struct HudCache
+    {
+        SDL_Texture *texture = nullptr;
+        bool isValid = false; // false after the render targets were reset
+        int textLength = 0;
+        unsigned long score = 0UL;
+        SnakeGameplaySystem::GameStatus status = SnakeGameplaySystem::GameStatus::PLAYING;
+        bool isPaused = false;
+    }; // struct HudCache
+    HudCache hud;
+
+    // RECTS fills a rectangle per occupied cell; TEXTURE draws the board as one
+    // pixel per cell, scaled up by a single SDL_RenderTexture(), which is what
+    // large boards need. Pick with --board-renderer rects|texture.
+    enum BoardRenderer
+    {
+        RECTS,
+        TEXTURE,
+    }; // enum BoardRenderer
+    BoardRenderer boardRenderer = BoardRenderer::TEXTURE;
+
+    struct BoardTexture
+    {
+        SDL_Texture *texture = nullptr;
+        long width = 0L;
+        long height = 0L;
+        Uint64 generation = 0U;
+        std::vector<Uint8> slots;   // board as last uploaded, row-major
+        std::vector<Uint32> pixels; // its colors, kept because a locked texture is write-only
+    }; // struct BoardTexture
+    BoardTexture boardTexture;
 } // namespace Global
 
+static double get_elapsed_ms(const Uint64 &startCounter)
+{
+    return static_cast<double>(SDL_GetPerformanceCounter() - startCounter) * 1000.0 / static_cast<double>(SDL_GetPerformanceFrequency());
+}
+
 static SDL_FRect get_centered_boundary(SDL_Window *window, const int &hMargin, const int &vMargin)
 {
     SDL_assert(window != nullptr);
@@ -118,32 +233,79 @@ static bool render_map_border(SDL_Window *window, SDL_Renderer *renderer, const
     return true;
 }
 
-static bool render_gameplay_visuals(entt::registry &reg, SDL_Window *window, SDL_Renderer *renderer, const int &hMargin, const int &vMargin)
+static Global::PercentileSummary summarize(const RollingStats<Global::PERF_WINDOW> &samples)
+{
+    return Global::PercentileSummary{samples.get_percentile(50.0), samples.get_percentile(99.0), samples.get_max()};
+}
+
+// Drawn in the top-left corner, over the board.
+static bool render_perf_overlay(const Global::Snapshot &snapshot, SDL_Renderer *renderer)
 {
-    SDL_assert(window != nullptr);
     SDL_assert(renderer != nullptr);
-    if (!render_map_border(window, renderer, hMargin, vMargin))
+    static constexpr float LINE_HEIGHT_PX = 10.0f;
+    const struct
     {
+        const char *name;
+        Global::PercentileSummary summary;
+    } timings[] = {{"tick   ", snapshot.tickMs}, {"render ", summarize(Global::renderStats.renderMs)}, {"present", summarize(Global::renderStats.presentMs)}};
+
+    if (!SDL_SetRenderDrawColor(renderer, 255U, 255U, 0U, SDL_ALPHA_OPAQUE))
+    {
+        std::cerr << "SDL_SetRenderDrawColor error: " << SDL_GetError() << std::endl;
         return false;
     }
+    float y = 4.0f;
+    for (const auto &timing : timings)
+    {
+        if (!SDL_RenderDebugTextFormat(renderer, 4.0f, y, "%s ms p50 %7.3f p99 %7.3f max %7.3f", timing.name,
+                                       timing.summary.p50, timing.summary.p99, timing.summary.max))
+        {
+            std::cerr << "SDL_RenderDebugTextFormat error: " << SDL_GetError() << std::endl;
+            return false;
+        }
+        y += LINE_HEIGHT_PX;
+    }
+    if (!SDL_RenderDebugTextFormat(renderer, 4.0f, y, "ticks/frame p50 %.0f p99 %.0f max %.0f", snapshot.ticksPerFrame.p50,
+                                   snapshot.ticksPerFrame.p99, snapshot.ticksPerFrame.max) ||
+        !SDL_RenderDebugTextFormat(renderer, 4.0f, y + LINE_HEIGHT_PX, "catch-up p50 %.0f p99 %.0f max %.0f total %lu", snapshot.catchUpTicks.p50,
+                                   snapshot.catchUpTicks.p99, snapshot.catchUpTicks.max, snapshot.catchUpTotal))
+    {
+        std::cerr << "SDL_RenderDebugTextFormat error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    y += 2.0f * LINE_HEIGHT_PX;
 
-    auto gameplayVecVec = SnakeGameplaySystem::get_map(reg);
-    SDL_FRect mapBoundaryBox = get_centered_boundary(window, hMargin, vMargin);
-    const float gridHeight = static_cast<float>(mapBoundaryBox.h) / static_cast<float>(gameplayVecVec.size());
-    for (int i = 0; i < gameplayVecVec.size(); i++)
+    if (!SDL_RenderDebugTextFormat(renderer, 4.0f, y, "entities %zu board %ldx%ld", snapshot.entityCount, snapshot.width, snapshot.height))
+    {
+        std::cerr << "SDL_RenderDebugTextFormat error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static SDL_Color get_slot_color(const Uint8 &slot)
+{
+    const Uint8 r = (slot & SnakeGameplaySystem::MapSlotState::APPLE) ? 255U : 0U;
+    const Uint8 g = (slot & SnakeGameplaySystem::MapSlotState::SNAKE_BODY) ? 255U : 0U;
+    const Uint8 b = (slot & SnakeGameplaySystem::MapSlotState::SNAKE_HEAD) ? 255U : 0U;
+    return SDL_Color{r, g, b, SDL_ALPHA_OPAQUE};
+}
+
+static bool render_board_rects(SDL_Renderer *renderer, const SnakeGameplaySystem::BoardView &board, const SDL_FRect &mapBoundaryBox)
+{
+    const float gridHeight = static_cast<float>(mapBoundaryBox.h) / static_cast<float>(board.height);
+    for (int i = 0; i < board.height; i++)
     {
-        const float gridWidth = static_cast<float>(mapBoundaryBox.w) / static_cast<float>(gameplayVecVec[i].size());
-        for (int j = 0; j < gameplayVecVec[i].size(); j++)
+        const float gridWidth = static_cast<float>(mapBoundaryBox.w) / static_cast<float>(board.width);
+        for (int j = 0; j < board.width; j++)
         {
-            const Uint8 r = (gameplayVecVec[i][j] & SnakeGameplaySystem::MapSlotState::APPLE) ? 255U : 0U;
-            const Uint8 g = (gameplayVecVec[i][j] & SnakeGameplaySystem::MapSlotState::SNAKE_BODY) ? 255U : 0U;
-            const Uint8 b = (gameplayVecVec[i][j] & SnakeGameplaySystem::MapSlotState::SNAKE_HEAD) ? 255U : 0U;
+            const SDL_Color color = get_slot_color(board.data[i * board.stride + j]);
             const float xCoord = static_cast<float>(j) * gridWidth + mapBoundaryBox.x;
             const float yCoord = static_cast<float>(i) * gridHeight + mapBoundaryBox.y;
             SDL_FRect grid = {xCoord, yCoord, gridWidth, gridHeight};
-            if (r > 0 || g > 0 || b > 0)
+            if (color.r > 0 || color.g > 0 || color.b > 0)
             {
-                if (!SDL_SetRenderDrawColor(renderer, r, g, b, SDL_ALPHA_OPAQUE))
+                if (!SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a))
                 {
                     std::cerr << "SDL_SetRenderDrawColor error: " << SDL_GetError() << std::endl;
                     return false;
@@ -156,85 +318,376 @@ static bool render_gameplay_visuals(entt::registry &reg, SDL_Window *window, SDL
             }
         }
     }
+    return true;
+}
 
-    if (!SDL_SetRenderDrawColor(renderer, 255U, 255U, 255U, SDL_ALPHA_OPAQUE))
+// Compares the board with the copy last uploaded and sends only the rows and
+// columns that changed, through one lock of the streaming texture.
+static bool update_board_texture(SDL_Renderer *renderer, const SnakeGameplaySystem::BoardView &board)
+{
+    Global::BoardTexture &boardTexture = Global::boardTexture;
+    const bool isResized = boardTexture.texture == nullptr || boardTexture.width != board.width || boardTexture.height != board.height;
+    if (isResized)
     {
-        std::cerr << "SDL_SetRenderDrawColor error: " << SDL_GetError() << std::endl;
-        return false;
+        SDL_DestroyTexture(boardTexture.texture);
+        boardTexture.texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_XRGB8888, SDL_TEXTUREACCESS_STREAMING, static_cast<int>(board.width), static_cast<int>(board.height));
+        if (boardTexture.texture == nullptr)
+        {
+            std::cerr << "SDL_CreateTexture error: " << SDL_GetError() << std::endl;
+            return false;
+        }
+        if (!SDL_SetTextureScaleMode(boardTexture.texture, SDL_SCALEMODE_NEAREST))
+        {
+            std::cerr << "SDL_SetTextureScaleMode error: " << SDL_GetError() << std::endl;
+            return false;
+        }
+        boardTexture.width = board.width;
+        boardTexture.height = board.height;
+        boardTexture.slots.assign(static_cast<size_t>(board.width * board.height), SnakeGameplaySystem::MapSlotState::EMPTY);
+        boardTexture.pixels.assign(static_cast<size_t>(board.width * board.height), 0U);
     }
+    else if (boardTexture.generation == board.generation)
+        return true;
 
-    const float textY = mapBoundaryBox.y + mapBoundaryBox.h + 10.0f;
-    std::string textContent;
-    if (Global::isGamePaused)
+    // Pixels are 0x00RRGGBB; the first upload sends the whole board, since the texture starts undefined.
+    long minX = isResized ? 0L : board.width, maxX = isResized ? board.width - 1L : -1L;
+    long minY = isResized ? 0L : board.height, maxY = isResized ? board.height - 1L : -1L;
+    for (long i = 0; i < board.height; i++)
     {
-        if (!SDL_SetRenderDrawColor(renderer, 255U, 255U, 255U, SDL_ALPHA_OPAQUE))
+        const Uint8 *row = board.data + i * board.stride;
+        Uint8 *uploadedRow = boardTexture.slots.data() + i * board.width;
+        for (long j = 0; j < board.width; j++)
         {
-            std::cerr << "SDL_SetRenderDrawColor error: " << SDL_GetError() << std::endl;
-            return false;
+            if (row[j] == uploadedRow[j])
+                continue;
+            uploadedRow[j] = row[j];
+            const SDL_Color color = get_slot_color(row[j]);
+            boardTexture.pixels[i * board.width + j] = (static_cast<Uint32>(color.r) << 16) | (static_cast<Uint32>(color.g) << 8) | color.b;
+            minX = std::min(minX, j);
+            maxX = std::max(maxX, j);
+            minY = std::min(minY, i);
+            maxY = std::max(maxY, i);
         }
-        textContent = "Game paused. Press ESC to resume. Score: %lu";
     }
-    else if (SnakeGameplaySystem::is_game_success(reg))
+    boardTexture.generation = board.generation;
+    if (maxX < minX)
+        return true;
+
+    const SDL_Rect rect = {static_cast<int>(minX), static_cast<int>(minY), static_cast<int>(maxX - minX + 1L), static_cast<int>(maxY - minY + 1L)};
+    void *pixels;
+    int pitch;
+    if (!SDL_LockTexture(boardTexture.texture, &rect, &pixels, &pitch))
+    {
+        std::cerr << "SDL_LockTexture error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    for (int i = 0; i < rect.h; i++)
+        std::memcpy(static_cast<Uint8 *>(pixels) + i * pitch, boardTexture.pixels.data() + (rect.y + i) * board.width + rect.x, static_cast<size_t>(rect.w) * sizeof(Uint32));
+    SDL_UnlockTexture(boardTexture.texture);
+    return true;
+}
+
+static bool render_board_texture(SDL_Renderer *renderer, const SnakeGameplaySystem::BoardView &board, const SDL_FRect &mapBoundaryBox)
+{
+    if (!update_board_texture(renderer, board))
+        return false;
+    if (!SDL_RenderTexture(renderer, Global::boardTexture.texture, nullptr, &mapBoundaryBox))
+    {
+        std::cerr << "SDL_RenderTexture error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static bool update_hud_texture(SDL_Renderer *renderer, const unsigned long &score, const SnakeGameplaySystem::GameStatus &status, const bool &isPaused)
+{
+    Global::HudCache &hud = Global::hud;
+    if (hud.texture == nullptr)
     {
-        if (!SDL_SetRenderDrawColor(renderer, 0U, 255U, 0U, SDL_ALPHA_OPAQUE))
+        hud.texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET,
+                                        Global::HUD_MAX_CHARS * SDL_DEBUG_TEXT_FONT_CHARACTER_SIZE, SDL_DEBUG_TEXT_FONT_CHARACTER_SIZE);
+        if (hud.texture == nullptr)
         {
-            std::cerr << "SDL_SetRenderDrawColor error: " << SDL_GetError() << std::endl;
+            std::cerr << "SDL_CreateTexture error: " << SDL_GetError() << std::endl;
             return false;
         }
-        textContent = "Congratulations! You won! Press R to restart. Score: %lu";
-    }
-    else if (SnakeGameplaySystem::is_game_failure(reg))
-    {
-        if (!SDL_SetRenderDrawColor(renderer, 255U, 0U, 0U, SDL_ALPHA_OPAQUE))
+        if (!SDL_SetTextureBlendMode(hud.texture, SDL_BLENDMODE_BLEND))
         {
-            std::cerr << "SDL_SetRenderDrawColor error: " << SDL_GetError() << std::endl;
+            std::cerr << "SDL_SetTextureBlendMode error: " << SDL_GetError() << std::endl;
             return false;
         }
-        textContent = "Game over! Press R to restart. Score: %lu";
     }
-    else
-        textContent = "Score: %lu";
 
-    if (!SDL_RenderDebugTextFormat(renderer, mapBoundaryBox.x, textY, textContent.c_str(), SnakeGameplaySystem::get_score(reg)))
+    SDL_Color color = {255U, 255U, 255U, SDL_ALPHA_OPAQUE};
+    const char *format = "Score: %lu";
+    if (isPaused)
+        format = "Game paused. Press ESC to resume. Score: %lu";
+    else if (status == SnakeGameplaySystem::GameStatus::WON)
     {
-        std::cerr << "SDL_RenderDebugTextFormat error: " << SDL_GetError() << std::endl;
+        color = {0U, 255U, 0U, SDL_ALPHA_OPAQUE};
+        format = "Congratulations! You won! Press R to restart. Score: %lu";
+    }
+    else if (status == SnakeGameplaySystem::GameStatus::LOST)
+    {
+        color = {255U, 0U, 0U, SDL_ALPHA_OPAQUE};
+        format = "Game over! Press R to restart. Score: %lu";
+    }
+    char text[Global::HUD_MAX_CHARS + 1];
+    const int length = std::snprintf(text, sizeof(text), format, score);
+
+    if (!SDL_SetRenderTarget(renderer, hud.texture))
+    {
+        std::cerr << "SDL_SetRenderTarget error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    const bool isDrawn = SDL_SetRenderDrawColor(renderer, 0U, 0U, 0U, SDL_ALPHA_TRANSPARENT) && SDL_RenderClear(renderer) &&
+                         SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a) && SDL_RenderDebugText(renderer, 0.0f, 0.0f, text);
+    if (!isDrawn)
+        std::cerr << "HUD texture error: " << SDL_GetError() << std::endl;
+    if (!SDL_SetRenderTarget(renderer, nullptr))
+    {
+        std::cerr << "SDL_SetRenderTarget error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    if (!isDrawn)
+        return false;
+
+    hud.isValid = true;
+    hud.textLength = std::min(std::max(length, 0), Global::HUD_MAX_CHARS);
+    hud.score = score;
+    hud.status = status;
+    hud.isPaused = isPaused;
+    return true;
+}
+
+static bool render_hud(const Global::Snapshot &snapshot, SDL_Renderer *renderer, const float &x, const float &y)
+{
+    SDL_assert(renderer != nullptr);
+    const Global::HudCache &hud = Global::hud;
+    if (!hud.isValid || hud.score != snapshot.score || hud.status != snapshot.status || hud.isPaused != snapshot.isPaused)
+    {
+        if (!update_hud_texture(renderer, snapshot.score, snapshot.status, snapshot.isPaused))
+            return false;
+    }
+
+    const float width = static_cast<float>(hud.textLength * SDL_DEBUG_TEXT_FONT_CHARACTER_SIZE);
+    const float height = static_cast<float>(SDL_DEBUG_TEXT_FONT_CHARACTER_SIZE);
+    const SDL_FRect source = {0.0f, 0.0f, width, height};
+    const SDL_FRect destination = {x, y, width, height};
+    if (!SDL_RenderTexture(renderer, hud.texture, &source, &destination))
+    {
+        std::cerr << "SDL_RenderTexture error: " << SDL_GetError() << std::endl;
         return false;
     }
+    return true;
+}
 
+static bool render_gameplay_visuals(const Global::Snapshot &snapshot, SDL_Window *window, SDL_Renderer *renderer, const int &hMargin, const int &vMargin)
+{
+    SDL_assert(window != nullptr);
+    SDL_assert(renderer != nullptr);
+    const Uint64 renderStart = SDL_GetPerformanceCounter();
+    if (!render_map_border(window, renderer, hMargin, vMargin))
+    {
+        return false;
+    }
+
+    const SnakeGameplaySystem::BoardView board = {snapshot.slots.data(), snapshot.width, snapshot.height, snapshot.width, snapshot.generation};
+    SDL_FRect mapBoundaryBox = get_centered_boundary(window, hMargin, vMargin);
+    if (Global::boardRenderer == Global::BoardRenderer::TEXTURE && !render_board_texture(renderer, board, mapBoundaryBox))
+    {
+        std::cerr << "Drawing the board with rectangles instead" << std::endl;
+        Global::boardRenderer = Global::BoardRenderer::RECTS;
+    }
+    if (Global::boardRenderer == Global::BoardRenderer::RECTS && !render_board_rects(renderer, board, mapBoundaryBox))
+        return false;
+
+    const float textY = mapBoundaryBox.y + mapBoundaryBox.h + 10.0f;
+    if (!render_hud(snapshot, renderer, mapBoundaryBox.x, textY))
+        return false;
+
+    if (Global::isPerfOverlayShown.load(std::memory_order_relaxed) && !render_perf_overlay(snapshot, renderer))
+        return false;
+    Global::renderStats.renderMs.add(get_elapsed_ms(renderStart));
+
+    const Uint64 presentStart = SDL_GetPerformanceCounter();
     if (!SDL_RenderPresent(renderer))
     {
         std::cerr << "SDL_RenderPresent error: " << SDL_GetError() << std::endl;
         return false;
     }
+    Global::renderStats.presentMs.add(get_elapsed_ms(presentStart));
 
     return true;
 }
 
 static void init_gameplay_scene(entt::registry &reg)
 {
-    reg.clear();
-    auto gameStateEntity = reg.create();
-    reg.emplace<DeltaTime>(gameStateEntity, Global::DESIRED_TICK_PERIOD_MS);
-    reg.emplace<KeyControl>(gameStateEntity, 'd', false);
-    reg.emplace<SnakeBoundary2D>(gameStateEntity, Global::MAP_WIDTH, Global::MAP_HEIGHT);
-
-    auto appleEntity = reg.create();
-    const float centerX = static_cast<float>(Global::MAP_WIDTH) / 2.0f;
-    const float centerY = static_cast<float>(Global::MAP_HEIGHT) / 2.0f;
-    reg.emplace<Position>(appleEntity, centerX, centerY);
-    reg.emplace<SnakeApple>(appleEntity);
-
-    auto snakeHeadEntity = reg.create();
-    if (centerY >= 1.5f)
-        reg.emplace<Position>(snakeHeadEntity, 2.5f, centerY - 1.0f);
-    else
-        reg.emplace<Position>(snakeHeadEntity, 2.5f, 0.5f);
-    reg.emplace<Velocity>(snakeHeadEntity, 0.0f, 0.0f);
-    reg.emplace<SnakePartHead>(snakeHeadEntity, Global::SPEED, Global::SPEED_UP_FACTOR);
+    // Seeded from the clock, so every restart plays out differently.
+    SnakeGameplaySystem::spawn_scene(reg, Global::MAP_WIDTH, Global::MAP_HEIGHT, SDL_GetPerformanceCounter(),
+                                     Global::DESIRED_TICK_PERIOD_MS, Global::SPEED, Global::SPEED_UP_FACTOR);
+    Global::SnakeGameplay::init(reg);
+}
+
+static bool is_game_idle(entt::registry &reg)
+{
+    return Global::isGamePaused || Global::SnakeGameplay::get_status(reg) != SnakeGameplaySystem::GameStatus::PLAYING;
+}
+
+static void publish_snapshot(entt::registry &reg)
+{
+    Global::Snapshot &snapshot = Global::snapshots.get_write_buffer();
+    const SnakeGameplaySystem::BoardView board = Global::SnakeGameplay::get_board_view(reg);
+    snapshot.slots.resize(static_cast<size_t>(board.width * board.height));
+    for (long i = 0; i < board.height; i++)
+        std::memcpy(snapshot.slots.data() + i * board.width, board.data + i * board.stride, static_cast<size_t>(board.width));
+    snapshot.width = board.width;
+    snapshot.height = board.height;
+    snapshot.generation = board.generation;
+    snapshot.score = SnakeGameplaySystem::get_score(reg);
+    snapshot.status = Global::SnakeGameplay::get_status(reg);
+    snapshot.isPaused = Global::isGamePaused;
+    snapshot.entityCount = static_cast<size_t>(reg.storage<entt::entity>().free_list());
+    if (Global::isPerfOverlayShown.load(std::memory_order_relaxed))
+    {
+        snapshot.tickMs = summarize(Global::tickStats.tickMs);
+        snapshot.ticksPerFrame = summarize(Global::tickStats.ticksPerFrame);
+        snapshot.catchUpTicks = summarize(Global::tickStats.catchUpTicks);
+        snapshot.catchUpTotal = Global::tickStats.catchUpTotal;
+    }
+    Global::snapshots.publish();
+
+    SDL_Event event = {};
+    event.type = Global::snapshotEventType;
+    SDL_PushEvent(&event);
+}
+
+// Returns whether a new snapshot is due; steering alone shows up at the next tick.
+static bool apply_input(entt::registry &reg)
+{
+    bool isSnapshotDue = false;
+    Global::InputCommand command;
+    while (Global::inputQueue.try_pop(command))
+    {
+        switch (command)
+        {
+        case Global::InputCommand::UP_KEY_DOWN:
+            SnakeGameplaySystem::Control::up_key_down(reg);
+            break;
+        case Global::InputCommand::LEFT_KEY_DOWN:
+            SnakeGameplaySystem::Control::left_key_down(reg);
+            break;
+        case Global::InputCommand::DOWN_KEY_DOWN:
+            SnakeGameplaySystem::Control::down_key_down(reg);
+            break;
+        case Global::InputCommand::RIGHT_KEY_DOWN:
+            SnakeGameplaySystem::Control::right_key_down(reg);
+            break;
+        case Global::InputCommand::SHIFT_KEY_DOWN:
+            SnakeGameplaySystem::Control::shift_key_down(reg);
+            break;
+        case Global::InputCommand::SHIFT_KEY_UP:
+            SnakeGameplaySystem::Control::shift_key_up(reg);
+            break;
+        case Global::InputCommand::TOGGLE_PAUSE:
+            if (Global::SnakeGameplay::get_status(reg) == SnakeGameplaySystem::GameStatus::PLAYING)
+            {
+                Global::isGamePaused = !Global::isGamePaused;
+                isSnapshotDue = true;
+            }
+            break;
+        case Global::InputCommand::RESTART:
+            if (Global::SnakeGameplay::get_status(reg) != SnakeGameplaySystem::GameStatus::PLAYING)
+            {
+                init_gameplay_scene(reg);
+                isSnapshotDue = true;
+            }
+            break;
+        case Global::InputCommand::PUBLISH_SNAPSHOT:
+            isSnapshotDue = true;
+            break;
+        }
+    }
+    return isSnapshotDue;
+}
+
+// Runs the fixed-step simulation on its own thread, so a slow present on the
+// main thread does not hold up ticks. Sleeps until the next tick or input is due.
+static int run_simulation(void *)
+{
+    entt::registry &reg = Global::reg;
+    Uint64 previousTick = SDL_GetTicks(); // for FixedUpdate() equivalent
+    Uint64 publishedGeneration = Global::SnakeGameplay::get_board_view(reg).generation;
+    bool isIdle = false;
+    while (!Global::isSimulationStopping.load(std::memory_order_acquire))
+    {
+        const bool isSnapshotDue = apply_input(reg);
+        if (is_game_idle(reg))
+        {
+            // Paused, won or lost: nothing moves until a key arrives.
+            if (!isIdle || isSnapshotDue)
+                publish_snapshot(reg);
+            isIdle = true;
+            SDL_WaitSemaphore(Global::inputSignal);
+            continue;
+        }
+        if (isIdle)
+        {
+            isIdle = false;
+            previousTick = SDL_GetTicks(); // no catch-up ticks for the time spent idle
+        }
+
+        const Uint64 now = SDL_GetTicks();
+        int ticksThisFrame = 0;
+        while (now - previousTick >= Global::DESIRED_TICK_PERIOD_MS) // for FixedUpdate() equivalent
+        {
+            // The reason why is because of how the body follows the head.
+            // It is dependent on body entites 2 blocks away in 4 directions from head.
+            // If system lags, the head may get detached if deltaTime is not fixed.
+            if (!is_game_idle(reg))
+            {
+                const Uint64 tickStart = SDL_GetPerformanceCounter();
+                Global::GameplayPipeline::iterate(reg); // effectively pauses game if failed or succeeded
+                Global::tickStats.tickMs.add(get_elapsed_ms(tickStart));
+            }
+            previousTick += Global::DESIRED_TICK_PERIOD_MS;
+            ticksThisFrame++;
+        }
+        if (ticksThisFrame > 0)
+        {
+            Global::tickStats.ticksPerFrame.add(static_cast<double>(ticksThisFrame));
+            Global::tickStats.catchUpTicks.add(static_cast<double>(ticksThisFrame - 1));
+            Global::tickStats.catchUpTotal += static_cast<unsigned long>(ticksThisFrame - 1);
+        }
+
+        const Uint64 generation = Global::SnakeGameplay::get_board_view(reg).generation;
+        if (isSnapshotDue || generation != publishedGeneration || (ticksThisFrame > 0 && Global::isPerfOverlayShown.load(std::memory_order_relaxed)))
+        {
+            publishedGeneration = generation;
+            publish_snapshot(reg);
+        }
+
+        const Uint64 nextTick = previousTick + Global::DESIRED_TICK_PERIOD_MS;
+        const Uint64 afterTicks = SDL_GetTicks();
+        SDL_WaitSemaphoreTimeout(Global::inputSignal, nextTick > afterTicks ? static_cast<Sint32>(nextTick - afterTicks) : 0);
+    }
+    return 0;
 }
 
 SDL_AppResult SDL_AppInit(void **appstate, int argc, char **argv)
 {
+    for (int i = 1; i + 1 < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--board-renderer") != 0)
+            continue;
+        if (std::strcmp(argv[i + 1], "rects") == 0)
+            Global::boardRenderer = Global::BoardRenderer::RECTS;
+        else if (std::strcmp(argv[i + 1], "texture") == 0)
+            Global::boardRenderer = Global::BoardRenderer::TEXTURE;
+        else
+            std::cerr << "Unknown board renderer: " << argv[i + 1] << std::endl;
+    }
+
     if (!SDL_Init(SDL_INIT_VIDEO))
     {
         std::cerr << "SDL_Init error: " << SDL_GetError() << std::endl;
@@ -266,13 +719,26 @@ SDL_AppResult SDL_AppInit(void **appstate, int argc, char **argv)
         return SDL_APP_FAILURE;
     }
 
-    init_gameplay_scene(Global::reg);
-    SystemTranslate2D::init(Global::gameplayUpdateSig);
-    SnakeGameplaySystem::init(Global::gameplayUpdateSig, Global::reg);
+    Global::snapshotEventType = SDL_RegisterEvents(1);
+    Global::inputSignal = SDL_CreateSemaphore(0U);
+    if (Global::snapshotEventType == 0U || Global::inputSignal == nullptr)
+    {
+        std::cerr << "SDL_RegisterEvents/SDL_CreateSemaphore error: " << SDL_GetError() << std::endl;
+        return SDL_APP_FAILURE;
+    }
 
-    render_gameplay_visuals(Global::reg, appstateCasted->window, appstateCasted->renderer, Global::MAP_MARGIN_PX, Global::MAP_MARGIN_PX);
+    // The first snapshot is published from here; the simulation thread takes over writing after.
+    init_gameplay_scene(Global::reg);
+    publish_snapshot(Global::reg);
+    Global::snapshots.update();
+    render_gameplay_visuals(Global::snapshots.read(), appstateCasted->window, appstateCasted->renderer, Global::MAP_MARGIN_PX, Global::MAP_MARGIN_PX);
 
-    appstateCasted->previousTick = SDL_GetTicks(); // for FixedUpdate() equivalent
+    appstateCasted->simulationThread = SDL_CreateThread(run_simulation, "simulation", nullptr);
+    if (appstateCasted->simulationThread == nullptr)
+    {
+        std::cerr << "SDL_CreateThread error: " << SDL_GetError() << std::endl;
+        return SDL_APP_FAILURE;
+    }
     return SDL_APP_CONTINUE;
 }
 
@@ -280,35 +746,39 @@ SDL_AppResult SDL_AppIterate(void *appstate)
 {
     AppState *appstateCasted = static_cast<AppState *>(appstate);
 
-    const Uint64 now = SDL_GetTicks();
-    while (now - appstateCasted->previousTick >= Global::DESIRED_TICK_PERIOD_MS) // for FixedUpdate() equivalent
+    // Draw what the simulation thread published last, then sleep in the event queue;
+    // a new snapshot wakes it up as an event, like a key does.
+    if (Global::snapshots.update() || appstateCasted->isFrameStale)
     {
-        // The reason why is because of how the body follows the head.
-        // It is dependent on body entites 2 blocks away in 4 directions from head.
-        // If system lags, the head may get detached if deltaTime is not fixed.
-        if (!Global::isGamePaused && !SnakeGameplaySystem::is_game_success(Global::reg) && !SnakeGameplaySystem::is_game_failure(Global::reg))
-            Global::gameplayUpdateSig(Global::reg); // effectively pauses game if failed or succeeded
-        appstateCasted->previousTick += Global::DESIRED_TICK_PERIOD_MS;
-
-        static auto previousMap = SnakeGameplaySystem::get_map(Global::reg);
-        auto currentMap = SnakeGameplaySystem::get_map(Global::reg);
-        if (currentMap != previousMap || Global::isGamePaused)
-        {
-            previousMap = currentMap;
-            render_gameplay_visuals(Global::reg, appstateCasted->window, appstateCasted->renderer, Global::MAP_MARGIN_PX, Global::MAP_MARGIN_PX);
-        }
+        appstateCasted->isFrameStale = false;
+        render_gameplay_visuals(Global::snapshots.read(), appstateCasted->window, appstateCasted->renderer, Global::MAP_MARGIN_PX, Global::MAP_MARGIN_PX);
     }
-    SDL_Delay(Global::DESIRED_TICK_PERIOD_MS / 2U); // MUST BE DIVIDED BY >= 2U; saves some CPU
+    SDL_WaitEvent(nullptr);
 
     return SDL_APP_CONTINUE;
 }
 
+static void push_input(const Global::InputCommand &command)
+{
+    if (!Global::inputQueue.try_push(command))
+        std::cerr << "Input dropped: the simulation thread is not keeping up" << std::endl;
+    SDL_SignalSemaphore(Global::inputSignal);
+}
+
 SDL_AppResult SDL_AppEvent(void *appstate, SDL_Event *event)
 {
+    AppState *appstateCasted = static_cast<AppState *>(appstate);
     switch (event->type)
     {
     case SDL_EVENT_QUIT:
         return SDL_APP_SUCCESS;
+    case SDL_EVENT_WINDOW_EXPOSED:
+        appstateCasted->isFrameStale = true;
+        break;
+    case SDL_EVENT_RENDER_TARGETS_RESET:
+        Global::hud.isValid = false;
+        appstateCasted->isFrameStale = true;
+        break;
     case SDL_EVENT_KEY_DOWN:
     {
         const SDL_KeyboardEvent &eventKey = event->key;
@@ -316,32 +786,36 @@ SDL_AppResult SDL_AppEvent(void *appstate, SDL_Event *event)
         switch (scancode)
         {
         case SDL_SCANCODE_ESCAPE:
-            if (SnakeGameplaySystem::is_game_success(Global::reg) || SnakeGameplaySystem::is_game_failure(Global::reg))
+            if (Global::snapshots.read().status != SnakeGameplaySystem::GameStatus::PLAYING)
                 return SDL_APP_SUCCESS;
-            Global::isGamePaused = !Global::isGamePaused;
+            push_input(Global::InputCommand::TOGGLE_PAUSE);
             break;
         case SDL_SCANCODE_W:
         case SDL_SCANCODE_UP:
-            SnakeGameplaySystem::Control::up_key_down(Global::reg);
+            push_input(Global::InputCommand::UP_KEY_DOWN);
             break;
         case SDL_SCANCODE_A:
         case SDL_SCANCODE_LEFT:
-            SnakeGameplaySystem::Control::left_key_down(Global::reg);
+            push_input(Global::InputCommand::LEFT_KEY_DOWN);
             break;
         case SDL_SCANCODE_S:
         case SDL_SCANCODE_DOWN:
-            SnakeGameplaySystem::Control::down_key_down(Global::reg);
+            push_input(Global::InputCommand::DOWN_KEY_DOWN);
             break;
         case SDL_SCANCODE_D:
         case SDL_SCANCODE_RIGHT:
-            SnakeGameplaySystem::Control::right_key_down(Global::reg);
+            push_input(Global::InputCommand::RIGHT_KEY_DOWN);
             break;
         case SDL_SCANCODE_SPACE:
-            SnakeGameplaySystem::Control::shift_key_down(Global::reg);
+            push_input(Global::InputCommand::SHIFT_KEY_DOWN);
+            break;
+        case SDL_SCANCODE_F3:
+            Global::isPerfOverlayShown.store(!Global::isPerfOverlayShown.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            push_input(Global::InputCommand::PUBLISH_SNAPSHOT);
             break;
         case SDL_SCANCODE_R:
-            if (SnakeGameplaySystem::is_game_failure(Global::reg) || SnakeGameplaySystem::is_game_success(Global::reg))
-                init_gameplay_scene(Global::reg);
+            if (Global::snapshots.read().status != SnakeGameplaySystem::GameStatus::PLAYING)
+                push_input(Global::InputCommand::RESTART);
         default:
             break;
         }
@@ -352,7 +826,7 @@ SDL_AppResult SDL_AppEvent(void *appstate, SDL_Event *event)
         const SDL_KeyboardEvent &eventKey = event->key;
         const SDL_Scancode &scancode = eventKey.scancode;
         if (scancode == SDL_SCANCODE_SPACE)
-            SnakeGameplaySystem::Control::shift_key_up(Global::reg);
+            push_input(Global::InputCommand::SHIFT_KEY_UP);
     }
     default:
         break;
@@ -365,6 +839,15 @@ void SDL_AppQuit(void *appstate, SDL_AppResult result)
     if (appstate != NULL)
     {
         AppState *as = static_cast<AppState *>(appstate);
+        if (as->simulationThread != nullptr)
+        {
+            Global::isSimulationStopping.store(true, std::memory_order_release);
+            SDL_SignalSemaphore(Global::inputSignal);
+            SDL_WaitThread(as->simulationThread, nullptr);
+        }
+        SDL_DestroySemaphore(Global::inputSignal);
+        SDL_DestroyTexture(Global::hud.texture);
+        SDL_DestroyTexture(Global::boardTexture.texture);
         SDL_DestroyRenderer(as->renderer);
         SDL_DestroyWindow(as->window);
         delete as;
@@ -0,0 +1,243 @@
+#ifndef SRC_SYSTEM_CHANGE_TRACKER_HPP
+#define SRC_SYSTEM_CHANGE_TRACKER_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include <SDL3/SDL_stdinc.h>
+#include <entt/entt.hpp>
+
+#include <component/position.hpp>
+#include <component/snake_apple.hpp>
+#include <component/snake_boundary_2d.hpp>
+#include <component/snake_part.hpp>
+#include <component/snake_part_head.hpp>
+
+#include <system/resource.hpp>
+#include <system/snake_grid.hpp>
+
+// Entities and board slots that changed, as the registry's on_construct,
+// on_update and on_destroy signals for Position, SnakePart, SnakePartHead and
+// SnakeApple report them. A moved entity dirties the slot it left and the one
+// it is in; slots are row-major on the SnakeBoundary2D board.
+//
+// Changes are kept for this tick and the one before, and next_tick() moves on.
+// Each consumer holds a Cursor and asks what changed since it last looked, so
+// one that looks every tick only ever works on what changed. One that fell
+// further behind, or saw the board resized, is told to look at everything.
+//
+// Signals only fire through emplace(), patch(), replace(), remove() and
+// destroy(): code that writes a tracked component through a reference must
+// patch() it afterwards, or report a batch of moves with log_moved(). The
+// board size is only looked at by connect() and next_tick().
+class ChangeTracker
+{
+public:
+    struct Cursor
+    {
+        Uint64 tick = 0U; // 0 if it never looked
+        size_t cellCount = 0U;
+        size_t entityCount = 0U;
+    }; // struct Cursor
+
+    // Connects the signals the first time it is called on a registry.
+    static ChangeTracker &connect(entt::registry &reg)
+    {
+        if (ChangeTracker *changeTracker = Resource::find<ChangeTracker>(reg))
+            return *changeTracker;
+        ChangeTracker &changeTracker = Resource::get_or_emplace<ChangeTracker>(reg);
+        reg.on_construct<Position>().connect<&ChangeTracker::on_position_construct>(changeTracker);
+        reg.on_update<Position>().connect<&ChangeTracker::on_position_update>(changeTracker);
+        reg.on_destroy<Position>().connect<&ChangeTracker::on_position_destroy>(changeTracker);
+        connect_kind<SnakePart>(reg, changeTracker);
+        connect_kind<SnakePartHead>(reg, changeTracker);
+        connect_kind<SnakeApple>(reg, changeTracker);
+        changeTracker.sync_size(reg);
+        return changeTracker;
+    }
+
+    // Starts a new tick; what changed two ticks ago is forgotten.
+    void next_tick(entt::registry &reg)
+    {
+        tick++;
+        get_log(tick).cells.clear();
+        get_log(tick).entities.clear();
+        sync_size(reg);
+    }
+
+    // Reports count entities whose Positions were written in place, e.g. a page of
+    // a group at a time. All of them are logged; slots only where they changed.
+    void log_moved(const entt::entity *entities, const Position *positions, const size_t &count)
+    {
+        Log &log = get_log(tick);
+        log.entities.insert(log.entities.end(), entities, entities + count);
+        for (size_t i = 0U; i < count; i++)
+        {
+            const long cell = get_cell(positions[i]);
+            long &entityCell = get_entity_cell(entities[i]);
+            if (cell == entityCell)
+                continue;
+            if (entityCell >= 0L)
+                log.cells.push_back(entityCell);
+            if (cell >= 0L)
+                log.cells.push_back(cell);
+            entityCell = cell;
+        }
+    }
+
+    // Room for changeCount changes a tick, and for as many entities, without allocating.
+    void reserve(const size_t &changeCount)
+    {
+        for (Log &log : logs)
+        {
+            log.cells.reserve(2U * changeCount); // a move dirties two slots
+            log.entities.reserve(changeCount);
+        }
+        entityCells.reserve(changeCount);
+    }
+
+    // Where a consumer that looked at everything just now stands.
+    Cursor get_cursor() const { return Cursor{tick, get_log(tick).cells.size(), get_log(tick).entities.size()}; }
+
+    // Whether nothing changed since the cursor. False if it is too far behind to tell.
+    bool is_unchanged_since(const Cursor &cursor) const
+    {
+        if (!is_recent(cursor))
+            return false;
+        if (cursor.tick == tick)
+            return cursor.cellCount == get_log(tick).cells.size() && cursor.entityCount == get_log(tick).entities.size();
+        return cursor.cellCount == get_log(cursor.tick).cells.size() && cursor.entityCount == get_log(cursor.tick).entities.size() &&
+               get_log(tick).cells.empty() && get_log(tick).entities.empty();
+    }
+
+    // Calls cellFunc(index) for each slot and entityFunc(entity) for each entity
+    // that changed since the cursor, some maybe more than once, then moves the
+    // cursor to now. Returns false without calling anything if the cursor is too
+    // far behind; the caller looks at everything then, and the cursor moves too.
+    template <typename CellFunc, typename EntityFunc>
+    bool for_each_change(Cursor &cursor, CellFunc &&cellFunc, EntityFunc &&entityFunc) const
+    {
+        const bool isRecent = is_recent(cursor);
+        for (Uint64 logTick = cursor.tick; isRecent && logTick <= tick; logTick++)
+        {
+            const Log &log = get_log(logTick);
+            for (size_t i = logTick == cursor.tick ? cursor.cellCount : 0U; i < log.cells.size(); i++)
+                cellFunc(log.cells[i]);
+            for (size_t i = logTick == cursor.tick ? cursor.entityCount : 0U; i < log.entities.size(); i++)
+                entityFunc(log.entities[i]);
+        }
+        cursor = get_cursor();
+        return isRecent;
+    }
+    template <typename CellFunc>
+    bool for_each_dirty_cell(Cursor &cursor, CellFunc &&cellFunc) const
+    {
+        return for_each_change(cursor, cellFunc, [](const entt::entity &) {});
+    }
+    template <typename EntityFunc>
+    bool for_each_changed_entity(Cursor &cursor, EntityFunc &&entityFunc) const
+    {
+        return for_each_change(cursor, [](const long &) {}, entityFunc);
+    }
+
+private:
+    struct Log
+    {
+        std::vector<long> cells;
+        std::vector<entt::entity> entities;
+    }; // struct Log
+
+    Log &get_log(const Uint64 &logTick) { return logs[logTick & 1U]; }
+    const Log &get_log(const Uint64 &logTick) const { return logs[logTick & 1U]; }
+    bool is_recent(const Cursor &cursor) const { return cursor.tick != 0U && cursor.tick + 1U >= tick && cursor.tick >= resizeTick; }
+
+    template <typename Kind>
+    static void connect_kind(entt::registry &reg, ChangeTracker &changeTracker)
+    {
+        reg.on_construct<Kind>().template connect<&ChangeTracker::on_kind_change>(changeTracker);
+        reg.on_update<Kind>().template connect<&ChangeTracker::on_kind_change>(changeTracker);
+        reg.on_destroy<Kind>().template connect<&ChangeTracker::on_kind_change>(changeTracker);
+    }
+
+    // Slot of pos, or -1 if it is off the board.
+    long get_cell(const Position &pos) const
+    {
+        const long x = SnakeGameplaySystem::Detail::get_column_from_pos(pos.x);
+        const long y = SnakeGameplaySystem::Detail::get_row_from_pos(pos.y, height);
+        if (x < 0L || y < 0L || x >= width || y >= height)
+            return -1L;
+        return y * width + x;
+    }
+    // Slots recorded so far mean nothing on a resized board: every cursor falls
+    // behind, and the slot of every entity is worked out again.
+    void sync_size(entt::registry &reg)
+    {
+        const SnakeBoundary2D *boundary = Resource::find<SnakeBoundary2D>(reg);
+        const long boundaryWidth = boundary != nullptr ? boundary->x : 0L;
+        const long boundaryHeight = boundary != nullptr ? boundary->y : 0L;
+        if (boundaryWidth == width && boundaryHeight == height)
+            return;
+        width = boundaryWidth;
+        height = boundaryHeight;
+        tick += 2U;
+        resizeTick = tick;
+        for (Log &log : logs)
+        {
+            log.cells.clear();
+            log.entities.clear();
+        }
+        auto view = reg.view<Position>();
+        for (auto &entity : view)
+            get_entity_cell(entity) = get_cell(view.get<Position>(entity));
+    }
+    long &get_entity_cell(const entt::entity &entity)
+    {
+        const size_t id = static_cast<size_t>(entt::to_entity(entity));
+        if (id >= entityCells.size())
+            entityCells.resize(id + 1U, -1L);
+        return entityCells[id];
+    }
+
+    void mark(const entt::entity &entity, const long &cell)
+    {
+        Log &log = get_log(tick);
+        log.entities.push_back(entity);
+        if (cell >= 0L)
+            log.cells.push_back(cell);
+    }
+    void on_position_construct(entt::registry &reg, entt::entity entity)
+    {
+        const long cell = get_cell(reg.get<Position>(entity));
+        get_entity_cell(entity) = cell;
+        mark(entity, cell);
+    }
+    void on_position_update(entt::registry &reg, entt::entity entity)
+    {
+        const long cell = get_cell(reg.get<Position>(entity));
+        long &entityCell = get_entity_cell(entity);
+        if (entityCell >= 0L && entityCell != cell)
+            get_log(tick).cells.push_back(entityCell);
+        entityCell = cell;
+        mark(entity, cell);
+    }
+    void on_position_destroy(entt::registry &, entt::entity entity)
+    {
+        long &entityCell = get_entity_cell(entity);
+        mark(entity, entityCell);
+        entityCell = -1L;
+    }
+    // A SnakePart, SnakePartHead or SnakeApple came, went or changed: what its slot holds did.
+    void on_kind_change(entt::registry &, entt::entity entity)
+    {
+        mark(entity, get_entity_cell(entity));
+    }
+
+    Log logs[2]; // by tick, odd and even
+    Uint64 tick = 1U;
+    Uint64 resizeTick = 1U; // cursors from before it are too far behind
+    long width = 0L;        // board size the slots were recorded for
+    long height = 0L;
+    std::vector<long> entityCells; // slot of each entity's Position as last reported, -1 if none, by entity index
+}; // class ChangeTracker
+
+#endif // SRC_SYSTEM_CHANGE_TRACKER_HPP
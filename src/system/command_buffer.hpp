@@ -0,0 +1,169 @@
+#ifndef SRC_SYSTEM_COMMAND_BUFFER_HPP
+#define SRC_SYSTEM_COMMAND_BUFFER_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <entt/entt.hpp>
+
+#include <system/resource.hpp>
+#include <system/system_access.hpp>
+
+// Structural changes recorded while views are being walked and applied later in
+// one pass: entities to create, components to emplace (or replace) and entities
+// to destroy. A system records into the registry's buffer,
+//   Resource::get_or_emplace<CommandBuffer>(reg).destroy(entity);
+// and CommandBuffer::iterate, listed in the pipeline after the systems that
+// record, applies it at that tick boundary, e.g.
+//   using GameplayPipeline = SystemPipeline<SystemTranslate2D::iterate, SnakeGameplaySystem::iterate, CommandBuffer::iterate>;
+//
+// The buffer keeps its capacity across flushes, so a steady tick records and
+// applies without allocating.
+class CommandBuffer
+{
+public:
+    // Applying it creates entities and adds or removes components: it runs on its own.
+    using Access = SystemAccess<Reads<>, Writes<CommandBuffer, StructuralChange>>;
+
+    // Stands for an entity create() records, until the next apply().
+    struct Spawn
+    {
+        size_t index;
+    }; // struct Spawn
+
+    Spawn create() { return Spawn{spawnCount++}; }
+
+    template <typename Component, typename... Args>
+    void emplace(const entt::entity &entity, Args &&...args)
+    {
+        get_pool<Component>().record(entity, NO_SPAWN, Component{std::forward<Args>(args)...});
+    }
+    template <typename Component, typename... Args>
+    void emplace(const Spawn &spawn, Args &&...args)
+    {
+        get_pool<Component>().record(entt::null, spawn.index, Component{std::forward<Args>(args)...});
+    }
+
+    void destroy(const entt::entity &entity) { destroyed.push_back(entity); }
+
+    bool empty() const
+    {
+        if (spawnCount > 0U || !destroyed.empty())
+            return false;
+        return std::all_of(pools.begin(), pools.end(), [](const PoolEntry &pool)
+                           { return pool.second->empty(); });
+    }
+
+    // Creates the entities, then emplaces one component type at a time in entity
+    // order, then destroys in entity order. An entity that is destroyed gets no
+    // components, and the last of several emplaces of a type on an entity wins.
+    // Entities that are gone already are skipped.
+    void apply(entt::registry &reg)
+    {
+        spawned.clear();
+        for (size_t i = 0U; i < spawnCount; i++)
+            spawned.push_back(reg.create());
+        spawnCount = 0U;
+
+        std::sort(destroyed.begin(), destroyed.end(), is_before);
+        destroyed.erase(std::unique(destroyed.begin(), destroyed.end()), destroyed.end());
+        for (PoolEntry &pool : pools)
+            pool.second->apply(reg, spawned, destroyed);
+
+        for (const entt::entity &entity : destroyed)
+        {
+            if (reg.valid(entity))
+                reg.destroy(entity);
+        }
+        destroyed.clear();
+    }
+
+    // Applies the registry's buffer, if it has one and it holds anything.
+    static void flush(entt::registry &reg)
+    {
+        CommandBuffer *commandBuffer = Resource::find<CommandBuffer>(reg);
+        if (commandBuffer != nullptr && !commandBuffer->empty())
+            commandBuffer->apply(reg);
+    }
+    static void iterate(entt::registry &reg) { flush(reg); }
+    static void update(entt::registry &reg) { return iterate(reg); }
+
+private:
+    static constexpr size_t NO_SPAWN = static_cast<size_t>(-1);
+
+    static bool is_before(const entt::entity &a, const entt::entity &b) { return entt::to_integral(a) < entt::to_integral(b); }
+
+    struct PoolBase
+    {
+        virtual ~PoolBase() = default;
+        virtual bool empty() const = 0;
+        virtual void apply(entt::registry &reg, const std::vector<entt::entity> &spawned, const std::vector<entt::entity> &destroyed) = 0;
+    }; // struct PoolBase
+
+    template <typename Component>
+    struct Pool : PoolBase
+    {
+        struct Record
+        {
+            entt::entity entity;
+            size_t spawnIndex; // NO_SPAWN if entity is set
+            size_t order;      // place among the records, so later ones win
+            Component component;
+        }; // struct Record
+
+        void record(const entt::entity &entity, const size_t &spawnIndex, Component &&component)
+        {
+            records.push_back(Record{entity, spawnIndex, records.size(), std::move(component)});
+        }
+        bool empty() const override { return records.empty(); }
+
+        void apply(entt::registry &reg, const std::vector<entt::entity> &spawned, const std::vector<entt::entity> &destroyed) override
+        {
+            for (Record &record : records)
+            {
+                if (record.spawnIndex != NO_SPAWN)
+                    record.entity = spawned[record.spawnIndex];
+            }
+            std::sort(records.begin(), records.end(), [](const Record &a, const Record &b)
+                      { return a.entity != b.entity ? is_before(a.entity, b.entity) : a.order < b.order; });
+
+            for (size_t i = 0U; i < records.size(); i++)
+            {
+                const entt::entity entity = records[i].entity;
+                if (i + 1U < records.size() && records[i + 1U].entity == entity)
+                    continue; // a later record replaces it
+                if (!reg.valid(entity) || std::binary_search(destroyed.begin(), destroyed.end(), entity, is_before))
+                    continue;
+                reg.emplace_or_replace<Component>(entity, std::move(records[i].component));
+            }
+            records.clear();
+        }
+
+        std::vector<Record> records;
+    }; // struct Pool
+
+    using PoolEntry = std::pair<entt::id_type, std::unique_ptr<PoolBase>>;
+
+    template <typename Component>
+    Pool<Component> &get_pool()
+    {
+        const entt::id_type id = entt::type_hash<Component>::value();
+        for (PoolEntry &pool : pools)
+        {
+            if (pool.first == id)
+                return static_cast<Pool<Component> &>(*pool.second);
+        }
+        pools.emplace_back(id, std::make_unique<Pool<Component>>());
+        return static_cast<Pool<Component> &>(*pools.back().second);
+    }
+
+    std::vector<PoolEntry> pools; // one per component type, in the order first recorded
+    std::vector<entt::entity> destroyed;
+    std::vector<entt::entity> spawned;
+    size_t spawnCount = 0U;
+}; // class CommandBuffer
+
+#endif // SRC_SYSTEM_COMMAND_BUFFER_HPP
@@ -0,0 +1,48 @@
+#ifndef SRC_SYSTEM_RESOURCE_HPP
+#define SRC_SYSTEM_RESOURCE_HPP
+
+#include <utility>
+
+#include <SDL3/SDL_assert.h>
+#include <entt/entt.hpp>
+
+// One value per type and registry, kept in reg.ctx(): the game state that used to
+// sit on its own entity (DeltaTime, KeyControl, SnakeBoundary2D, RandomState) and
+// the per-registry states of the systems. A lookup is a single hash of the type
+// instead of a view over a storage holding exactly one component.
+namespace Resource
+{
+    // Replaces any previous value.
+    template <typename T, typename... Args>
+    static T &set(entt::registry &reg, Args &&...args)
+    {
+        return reg.ctx().insert_or_assign(T{std::forward<Args>(args)...});
+    }
+
+    template <typename T>
+    static T *find(entt::registry &reg) { return reg.ctx().find<T>(); }
+    template <typename T>
+    static const T *find(const entt::registry &reg) { return reg.ctx().find<T>(); }
+
+    template <typename T>
+    static T &get(entt::registry &reg)
+    {
+        T *resource = reg.ctx().find<T>();
+        SDL_assert(resource != nullptr);
+        return *resource;
+    }
+
+    // Default constructs the value the first time it is asked for.
+    template <typename T>
+    static T &get_or_emplace(entt::registry &reg)
+    {
+        if (T *resource = reg.ctx().find<T>())
+            return *resource;
+        return reg.ctx().emplace<T>();
+    }
+
+    template <typename T>
+    static bool erase(entt::registry &reg) { return reg.ctx().erase<T>(); }
+} // namespace Resource
+
+#endif // SRC_SYSTEM_RESOURCE_HPP
@@ -0,0 +1,569 @@
+#ifndef SRC_SYSTEM_SNAKE_ARENA_SYSTEM_HPP
+#define SRC_SYSTEM_SNAKE_ARENA_SYSTEM_HPP
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <SDL3/SDL_assert.h>
+#include <SDL3/SDL_stdinc.h>
+#include <entt/entt.hpp>
+
+#include <component/position.hpp>
+#include <component/velocity.hpp>
+#include <component/key_control.hpp>
+#include <component/snake_apple.hpp>
+#include <component/snake_owner.hpp>
+#include <component/snake_part.hpp>
+#include <component/snake_part_head.hpp>
+#include <component/snake_boundary_2d.hpp>
+#include <component/random_state.hpp>
+
+#include <system/change_tracker.hpp>
+#include <system/snake_direction.hpp>
+#include <system/snake_grid.hpp>
+#include <system/snake_random.hpp>
+#include <system/resource.hpp>
+#include <system/system_access.hpp>
+#include <util/worker_pool.hpp>
+
+// Any number of snakes sharing one board. Every head carries its own KeyControl
+// (heads without one follow the KeyControl resource) and every SnakePart of a
+// snake carries a SnakeOwner pointing at its head.
+//
+// Each tick first plans every snake on its own, in parallel when a WorkerPool *
+// is in reg.ctx(), then resolves conflicts in head entity order:
+//  - a head leaving the board dies;
+//  - heads sharing a slot all die, and so do two heads that swapped slots
+//    (head-to-head);
+//  - a head in a body slot dies (head-to-body, its own body included). Tails
+//    moving out of the way and necks spawned this tick are taken into account.
+// Dead snakes are destroyed together with their parts.
+//
+// Call init() once the boundary is set, then run iterate() from a SystemPipeline,
+// or opt in at run time with RuntimeSystems::connect(reg, SnakeArenaSystem::iterate).
+namespace SnakeArenaSystem
+{
+    using SnakeGameplaySystem::Direction;
+    using SnakeGameplaySystem::DynamicGrid;
+    using SnakeGameplaySystem::MapSlotState;
+
+    using Access = SystemAccess<Reads<KeyControl, SnakeBoundary2D, SnakePartHead>,
+                                Writes<Position, Velocity, SnakePart, SnakeOwner, SnakeApple, RandomState, ChangeTracker, StructuralChange>>;
+
+    static void iterate(entt::registry &reg);
+    static void update(entt::registry &reg);
+    static bool init(entt::registry &reg);
+
+    // Creates a head (Position, Velocity, SnakePartHead, KeyControl) in slot (x, y), rows counted from the top.
+    static entt::entity spawn_snake(entt::registry &reg, const long &x, const long &y, const char &direction, const float &speed, const float &speedUpFactor);
+
+    static const DynamicGrid &get_board(entt::registry &reg);
+    static const std::vector<entt::entity> &get_dead_snakes(entt::registry &reg); // heads destroyed by the last iterate()
+    static unsigned long get_snake_count(entt::registry &reg);
+    static unsigned long get_score(entt::registry &reg, const entt::entity &head);
+
+    namespace Detail
+    {
+        using namespace SnakeGameplaySystem::Detail;
+
+        // Emplaced on a head the first time the system sees it.
+        struct HeadTrack
+        {
+            long previousHeadX; // slot as of the last iterate()
+            long previousHeadY;
+        }; // struct HeadTrack
+
+        struct Part
+        {
+            entt::entity entity;
+            long index; // slot, -1 if off the board
+            Direction direction;
+        }; // struct Part
+
+        struct Snake
+        {
+            entt::entity head;
+            std::vector<Part> parts; // capacity is kept between ticks
+            long previousHeadX;
+            long previousHeadY;
+
+            // Filled in by plan_snake().
+            long headIndex;
+            Direction direction; // direction the head travelled in, NO_DIRECTION if it did not
+            long spawnIndex;     // slot the head left, where the new neck goes
+            entt::entity tail;   // part to destroy this tick, entt::null if none
+            long tailIndex;
+            bool isAteApple;
+            bool isDead;
+        }; // struct Snake
+
+        // Slot and bits an entity put on the board, and the slot its SnakePart points at,
+        // so they can be taken off again.
+        struct Placement
+        {
+            entt::entity entity; // entt::null if the entity with this index put nothing there
+            long index;
+            Uint8 bits;
+            long pointedIndex; // -1 if it points at nothing
+        }; // struct Placement
+
+        struct State
+        {
+            DynamicGrid board;
+            std::vector<Uint8> pointedCounts;  // per slot, number of parts pointing at it
+            std::vector<Placement> placements; // by entity index
+            ChangeTracker::Cursor boardCursor; // as of the last time the board was brought up to date
+            std::vector<Snake> snakes;         // sorted by head entity; only the first snakeCount are in use
+            long snakeCount = 0L;
+            std::vector<entt::entity> heads;
+            std::vector<std::pair<long, long>> headSlots; // (slot, snake) for head-to-head
+            std::vector<std::pair<long, long>> leftSlots; // (slot the head left, snake) for swapped heads
+            std::vector<long> eatenSlots;
+            std::vector<entt::entity> eatenApples;
+            std::vector<entt::entity> deadSnakes;
+        }; // struct State
+
+        static State &get_state(entt::registry &reg)
+        {
+            if (State *state = Resource::find<State>(reg))
+                return *state;
+            ChangeTracker::connect(reg);
+            return Resource::get_or_emplace<State>(reg);
+        }
+
+        static bool get_slot(const DynamicGrid &board, const Position &pos, long *index)
+        {
+            long xIndex, yIndex;
+            board.get_index_from_pos(pos, &xIndex, &yIndex);
+            *index = board.is_in_bounds(xIndex, yIndex) ? board.to_index(xIndex, yIndex) : -1L;
+            return *index >= 0L;
+        }
+
+        static Placement &get_placement(State &state, const entt::entity &entity)
+        {
+            const size_t id = static_cast<size_t>(entt::to_entity(entity));
+            if (id >= state.placements.size())
+                state.placements.resize(id + 1U, Placement{entt::null, -1L, 0U, -1L});
+            return state.placements[id];
+        }
+        // Takes off the board what the entity put there.
+        static void lift(State &state, const entt::entity &entity)
+        {
+            Placement &placement = get_placement(state, entity);
+            if (placement.entity != entity)
+                return;
+            state.board.remove(placement.index, placement.bits);
+            if (placement.pointedIndex >= 0L)
+                state.pointedCounts[placement.pointedIndex]--;
+            placement.entity = entt::null;
+        }
+        // Puts bits in the slot for the entity, in place of what it put on the board before.
+        // A SNAKE_BODY part also points at the slot next to it in `direction`.
+        static void put(State &state, const entt::entity &entity, const long &index, const Uint8 &bits, const Direction &direction)
+        {
+            lift(state, entity);
+            long pointedIndex = -1L;
+            if ((bits & MapSlotState::SNAKE_BODY) && state.board.step(index, direction, &pointedIndex))
+                state.pointedCounts[pointedIndex]++;
+            else
+                pointedIndex = -1L;
+            state.board.add(index, bits);
+            get_placement(state, entity) = Placement{entity, index, bits, pointedIndex};
+        }
+        // Brings what the entity puts on the board up to date with the registry.
+        static void place(entt::registry &reg, State &state, const entt::entity &entity)
+        {
+            lift(state, entity);
+            if (!reg.valid(entity))
+                return;
+            const Position *pos = reg.try_get<Position>(entity);
+            long index;
+            if (pos == nullptr || !get_slot(state.board, *pos, &index))
+                return;
+            Uint8 bits = MapSlotState::EMPTY;
+            Direction direction = Direction::NO_DIRECTION;
+            if (const SnakePart *snakePart = reg.try_get<SnakePart>(entity))
+            {
+                bits |= MapSlotState::SNAKE_BODY;
+                direction = to_direction(snakePart->currentDirection);
+            }
+            if (reg.all_of<SnakePartHead>(entity))
+                bits |= MapSlotState::SNAKE_HEAD;
+            if (reg.all_of<SnakeApple>(entity))
+                bits |= MapSlotState::APPLE;
+            if (bits != MapSlotState::EMPTY)
+                put(state, entity, index, bits, direction);
+        }
+
+        // Moves what the entities the ChangeTracker saw change put on the board, or rebuilds
+        // it from the registry when the tracker cannot tell or the board was resized. A tick
+        // then costs what moved, not the arena's area. Every changed entity is lifted before
+        // any is put back, as one head may move into the slot another head just left.
+        static void build_board(entt::registry &reg, State &state)
+        {
+            const SnakeBoundary2D boundary = Resource::get<SnakeBoundary2D>(reg);
+            const ChangeTracker &changeTracker = Resource::get<ChangeTracker>(reg);
+            DynamicGrid &board = state.board;
+            ChangeTracker::Cursor liftCursor = state.boardCursor;
+            auto liftChanged = [&state](const entt::entity &entity)
+            { lift(state, entity); };
+            auto placeChanged = [&reg, &state](const entt::entity &entity)
+            { place(reg, state, entity); };
+            if (board.width() == boundary.x && board.height() == boundary.y && changeTracker.for_each_changed_entity(liftCursor, liftChanged))
+            {
+                changeTracker.for_each_changed_entity(state.boardCursor, placeChanged);
+                return;
+            }
+            state.boardCursor = changeTracker.get_cursor();
+            board.reset(boundary.x, boundary.y);
+            state.pointedCounts.assign(static_cast<size_t>(board.area()), 0U);
+            for (Placement &placement : state.placements)
+                placement.entity = entt::null;
+
+            for (auto &entity : reg.view<SnakePart, Position>())
+                place(reg, state, entity);
+            for (auto &entity : reg.view<SnakePartHead, Position>())
+                place(reg, state, entity);
+            for (auto &entity : reg.view<SnakeApple, Position>())
+                place(reg, state, entity);
+        }
+
+        // Sorts the heads, starts tracking new ones and sorts every owned part into its snake.
+        static void collect_snakes(entt::registry &reg, State &state)
+        {
+            const DynamicGrid &board = state.board;
+            auto snakeHeadView = reg.view<SnakePartHead, Position, Velocity>();
+            state.heads.clear();
+            for (auto &entity : snakeHeadView)
+                state.heads.push_back(entity);
+            std::sort(state.heads.begin(), state.heads.end());
+
+            state.snakeCount = static_cast<long>(state.heads.size());
+            if (state.snakes.size() < state.heads.size())
+                state.snakes.resize(state.heads.size());
+            for (long i = 0L; i < state.snakeCount; i++)
+            {
+                const entt::entity head = state.heads[i];
+                if (!reg.all_of<HeadTrack>(head))
+                {
+                    long xIndex, yIndex;
+                    board.get_index_from_pos(snakeHeadView.get<Position>(head), &xIndex, &yIndex);
+                    reg.emplace<HeadTrack>(head, xIndex, yIndex);
+                }
+                const HeadTrack &track = reg.get<HeadTrack>(head);
+                Snake &snake = state.snakes[i];
+                snake.head = head;
+                snake.parts.clear();
+                snake.previousHeadX = track.previousHeadX;
+                snake.previousHeadY = track.previousHeadY;
+            }
+
+            auto ownedPartView = reg.view<SnakePart, SnakeOwner, Position>();
+            for (auto &entity : ownedPartView)
+            {
+                const auto found = std::lower_bound(state.heads.begin(), state.heads.end(), ownedPartView.get<SnakeOwner>(entity).head);
+                if (found == state.heads.end() || *found != ownedPartView.get<SnakeOwner>(entity).head)
+                    continue; // orphaned part; it still blocks its slot
+                long index;
+                get_slot(board, ownedPartView.get<Position>(entity), &index);
+                state.snakes[found - state.heads.begin()].parts.push_back(Part{entity, index, to_direction(ownedPartView.get<SnakePart>(entity).currentDirection)});
+            }
+        }
+
+        // Only reads the registry apart from the Velocity of its own head, so snakes can be planned concurrently.
+        template <typename HeadView, typename KeyControlView>
+        static void plan_snake(const State &state, Snake &snake, const HeadView &snakeHeadView, const KeyControlView &keyControlView, const KeyControl *sharedKeyControl)
+        {
+            const DynamicGrid &board = state.board;
+            snake.direction = Direction::NO_DIRECTION;
+            snake.spawnIndex = snake.tailIndex = -1L;
+            snake.tail = entt::null;
+            snake.isAteApple = false;
+
+            const Position &pos = snakeHeadView.template get<Position>(snake.head);
+            snake.isDead = pos.x < 0.0f || pos.x >= board.width() || pos.y < 0.0f || pos.y >= board.height();
+            if (snake.isDead || !get_slot(board, pos, &snake.headIndex))
+            {
+                snake.isDead = true;
+                return;
+            }
+
+            long x, y;
+            board.from_index(snake.headIndex, &x, &y);
+            snake.direction = get_travelled_direction(snake.previousHeadX, snake.previousHeadY, x, y);
+            const bool isMoving = snake.direction != Direction::NO_DIRECTION;
+            if (isMoving)
+            {
+                snake.spawnIndex = board.to_index(x - DIRECTION_DX[snake.direction], y - DIRECTION_DY[snake.direction]);
+                snake.isAteApple = board.get(snake.headIndex) & MapSlotState::APPLE;
+                for (const Part &part : snake.parts)
+                {
+                    if (snake.isAteApple)
+                        break;
+                    if (part.index < 0L || state.pointedCounts[part.index] == 0U)
+                    {
+                        snake.tail = part.entity;
+                        snake.tailIndex = part.index;
+                        break;
+                    }
+                }
+            }
+
+            const KeyControl *keyControl = keyControlView.contains(snake.head) ? &keyControlView.template get<KeyControl>(snake.head) : sharedKeyControl;
+            if (keyControl == nullptr)
+                return;
+            const Direction directionToGo = to_direction(keyControl->lastMovementKeyDown);
+            if (directionToGo == Direction::NO_DIRECTION)
+                return;
+
+            // Going backwards means turning into the neck, which is the part spawned this tick if any.
+            bool isGoingBackwards = false;
+            if (isMoving && (!snake.parts.empty() || snake.isAteApple))
+                isGoingBackwards = directionToGo == OPPOSITE_DIRECTION[snake.direction];
+            else
+            {
+                long neckIndex;
+                if (board.step(snake.headIndex, directionToGo, &neckIndex))
+                {
+                    for (const Part &part : snake.parts)
+                        isGoingBackwards |= part.index == neckIndex && part.direction == OPPOSITE_DIRECTION[directionToGo];
+                }
+            }
+            if (isGoingBackwards)
+                return;
+
+            const SnakePartHead &headPart = snakeHeadView.template get<SnakePartHead>(snake.head);
+            Velocity &vel = snakeHeadView.template get<Velocity>(snake.head);
+            const float speed = headPart.speed * (keyControl->isShiftKeyDown ? headPart.speedUpFactor : 1.0f);
+            vel.x = DIRECTION_POS_DX[directionToGo] * speed;
+            vel.y = DIRECTION_POS_DY[directionToGo] * speed;
+        }
+
+        static void resolve_conflicts(State &state)
+        {
+            DynamicGrid &board = state.board;
+
+            state.headSlots.clear();
+            for (long i = 0L; i < state.snakeCount; i++)
+            {
+                if (!state.snakes[i].isDead)
+                    state.headSlots.emplace_back(state.snakes[i].headIndex, i);
+            }
+            std::sort(state.headSlots.begin(), state.headSlots.end());
+            for (size_t i = 1U; i < state.headSlots.size(); i++)
+            {
+                if (state.headSlots[i].first == state.headSlots[i - 1U].first)
+                    state.snakes[state.headSlots[i].second].isDead = state.snakes[state.headSlots[i - 1U].second].isDead = true;
+            }
+
+            // Two heads moving into each other's slot pass through one another, body or not.
+            state.leftSlots.clear();
+            for (const std::pair<long, long> &headSlot : state.headSlots)
+            {
+                if (state.snakes[headSlot.second].spawnIndex >= 0L)
+                    state.leftSlots.emplace_back(state.snakes[headSlot.second].spawnIndex, headSlot.second);
+            }
+            std::sort(state.leftSlots.begin(), state.leftSlots.end());
+            for (const std::pair<long, long> &leftSlot : state.leftSlots)
+            {
+                Snake &snake = state.snakes[leftSlot.second];
+                const auto found = std::lower_bound(state.leftSlots.begin(), state.leftSlots.end(), std::make_pair(snake.headIndex, 0L));
+                for (auto other = found; other != state.leftSlots.end() && other->first == snake.headIndex; other++)
+                {
+                    if (state.snakes[other->second].headIndex == snake.spawnIndex)
+                        snake.isDead = state.snakes[other->second].isDead = true;
+                }
+            }
+
+            // Every snake moves at once, so bodies are checked after all tails and necks have moved.
+            // Necks are only on the board until apply_moves() puts their entities there.
+            for (long i = 0L; i < state.snakeCount; i++)
+            {
+                const Snake &snake = state.snakes[i];
+                if (snake.tailIndex >= 0L)
+                    lift(state, snake.tail);
+            }
+            for (long i = 0L; i < state.snakeCount; i++)
+            {
+                const Snake &snake = state.snakes[i];
+                if (snake.spawnIndex >= 0L && (!snake.parts.empty() || snake.isAteApple))
+                    board.add(snake.spawnIndex, MapSlotState::SNAKE_BODY);
+            }
+            for (long i = 0L; i < state.snakeCount; i++)
+            {
+                Snake &snake = state.snakes[i];
+                if (!snake.isDead && snake.direction != Direction::NO_DIRECTION && (board.get(snake.headIndex) & MapSlotState::SNAKE_BODY))
+                    snake.isDead = true;
+            }
+        }
+
+        static void apply_moves(entt::registry &reg, State &state)
+        {
+            DynamicGrid &board = state.board;
+            state.eatenSlots.clear();
+            for (long i = 0L; i < state.snakeCount; i++)
+            {
+                Snake &snake = state.snakes[i];
+                const bool isGrowingNeck = snake.direction != Direction::NO_DIRECTION && (!snake.parts.empty() || snake.isAteApple);
+                if (isGrowingNeck)
+                    board.remove(snake.spawnIndex, MapSlotState::SNAKE_BODY); // put back with its entity below
+                if (snake.isDead)
+                {
+                    for (const Part &part : snake.parts)
+                    {
+                        lift(state, part.entity);
+                        reg.destroy(part.entity);
+                    }
+                    lift(state, snake.head);
+                    reg.destroy(snake.head);
+                    state.deadSnakes.push_back(snake.head);
+                    continue;
+                }
+
+                if (isGrowingNeck)
+                {
+                    long spawnX, spawnY;
+                    board.from_index(snake.spawnIndex, &spawnX, &spawnY);
+                    auto entitySnakePart = reg.create();
+                    reg.emplace<SnakePart>(entitySnakePart, DIRECTION_KEY[snake.direction]);
+                    reg.emplace<Position>(entitySnakePart, board.get_pos_from_index(spawnX, spawnY));
+                    reg.emplace<SnakeOwner>(entitySnakePart, snake.head);
+                    put(state, entitySnakePart, snake.spawnIndex, MapSlotState::SNAKE_BODY, snake.direction);
+                }
+                if (snake.tail != entt::null)
+                    reg.destroy(snake.tail);
+                if (snake.isAteApple)
+                    state.eatenSlots.push_back(snake.headIndex);
+
+                HeadTrack &track = reg.get<HeadTrack>(snake.head);
+                board.from_index(snake.headIndex, &track.previousHeadX, &track.previousHeadY);
+            }
+        }
+
+        // Dense boards draw among the empty slots directly; on sparse ones a few blind draws beat a scan.
+        static long get_random_empty_slot(entt::registry &reg, const DynamicGrid &board)
+        {
+            if (board.get_empty_count() <= 0L)
+                return -1L;
+            if (board.get_empty_count() * 4L >= board.area())
+            {
+                for (int attempt = 0; attempt < 8; attempt++)
+                {
+                    const long index = get_random(reg, static_cast<Sint32>(board.area()));
+                    if (board.get(index) == MapSlotState::EMPTY)
+                        return index;
+                }
+            }
+            long n = get_random(reg, static_cast<Sint32>(board.get_empty_count()));
+            for (long index = 0L; index < board.area(); index++)
+            {
+                if (board.get(index) == MapSlotState::EMPTY && n-- == 0L)
+                    return index;
+            }
+            return -1L;
+        }
+
+        static void respawn_apples(entt::registry &reg, State &state)
+        {
+            if (state.eatenSlots.empty())
+                return;
+            std::sort(state.eatenSlots.begin(), state.eatenSlots.end());
+            state.eatenApples.clear();
+            auto appleView = reg.view<SnakeApple, Position>();
+            for (auto &entity : appleView)
+            {
+                long index;
+                if (get_slot(state.board, appleView.get<Position>(entity), &index) && std::binary_search(state.eatenSlots.begin(), state.eatenSlots.end(), index))
+                    state.eatenApples.push_back(entity);
+            }
+            std::sort(state.eatenApples.begin(), state.eatenApples.end());
+
+            // apply_moves() left the board as the registry is, so only the eaten apples move.
+            for (auto &entity : state.eatenApples)
+            {
+                lift(state, entity);
+                const long index = get_random_empty_slot(reg, state.board);
+                if (index < 0L)
+                {
+                    reg.destroy(entity);
+                    continue;
+                }
+                long x, y;
+                state.board.from_index(index, &x, &y);
+                reg.replace<Position>(entity, state.board.get_pos_from_index(x, y));
+                put(state, entity, index, MapSlotState::APPLE, Direction::NO_DIRECTION);
+            }
+        }
+    } // namespace Detail
+
+    static void iterate(entt::registry &reg)
+    {
+        if (Resource::find<SnakeBoundary2D>(reg) == nullptr)
+            return;
+        Detail::State &state = Detail::get_state(reg);
+        Resource::get<ChangeTracker>(reg).next_tick(reg);
+        state.deadSnakes.clear();
+        Detail::build_board(reg, state);
+        Detail::collect_snakes(reg, state);
+
+        auto snakeHeadView = reg.view<SnakePartHead, Position, Velocity>();
+        auto keyControlView = reg.view<KeyControl>();
+        const KeyControl *sharedKeyControl = Resource::find<KeyControl>(reg);
+        auto planSnakes = [&state, &snakeHeadView, &keyControlView, &sharedKeyControl](const long &begin, const long &end)
+        {
+            for (long i = begin; i < end; i++)
+                Detail::plan_snake(state, state.snakes[i], snakeHeadView, keyControlView, sharedKeyControl);
+        };
+        if (WorkerPool **workerPool = Resource::find<WorkerPool *>(reg))
+            (*workerPool)->parallel_for(state.snakeCount, planSnakes);
+        else
+            planSnakes(0L, state.snakeCount);
+
+        Detail::resolve_conflicts(state);
+        Detail::apply_moves(reg, state);
+        Detail::respawn_apples(reg, state);
+    }
+    static void update(entt::registry &reg) { return iterate(reg); }
+
+    static bool init(entt::registry &reg)
+    {
+        if (Resource::find<SnakeBoundary2D>(reg) == nullptr)
+            return false;
+        Detail::State &state = Detail::get_state(reg);
+        Detail::build_board(reg, state);
+        Detail::collect_snakes(reg, state);
+        return true;
+    }
+
+    static entt::entity spawn_snake(entt::registry &reg, const long &x, const long &y, const char &direction, const float &speed, const float &speedUpFactor)
+    {
+        const SnakeBoundary2D boundary = Resource::get<SnakeBoundary2D>(reg);
+
+        auto entity = reg.create();
+        reg.emplace<Position>(entity, SnakeGameplaySystem::Detail::get_pos_from_cell(x, y, boundary.y));
+        reg.emplace<Velocity>(entity, 0.0f, 0.0f);
+        reg.emplace<SnakePartHead>(entity, speed, speedUpFactor);
+        reg.emplace<KeyControl>(entity, direction, false);
+        return entity;
+    }
+
+    static const DynamicGrid &get_board(entt::registry &reg)
+    {
+        Detail::State &state = Detail::get_state(reg);
+        Detail::build_board(reg, state);
+        return state.board;
+    }
+    static const std::vector<entt::entity> &get_dead_snakes(entt::registry &reg) { return Detail::get_state(reg).deadSnakes; }
+    static unsigned long get_snake_count(entt::registry &reg) { return reg.view<SnakePartHead>().size(); }
+    static unsigned long get_score(entt::registry &reg, const entt::entity &head)
+    {
+        unsigned long ret = 0UL;
+        auto ownedPartView = reg.view<SnakePart, SnakeOwner>();
+        for (auto &entity : ownedPartView)
+            ret += ownedPartView.get<SnakeOwner>(entity).head == head;
+        return ret;
+    }
+} // namespace SnakeArenaSystem
+
+#endif // SRC_SYSTEM_SNAKE_ARENA_SYSTEM_HPP
@@ -0,0 +1,370 @@
+#ifndef SRC_SYSTEM_SNAKE_AUTOPILOT_SYSTEM_HPP
+#define SRC_SYSTEM_SNAKE_AUTOPILOT_SYSTEM_HPP
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <SDL3/SDL_assert.h>
+#include <entt/entt.hpp>
+
+#include <component/position.hpp>
+#include <component/key_control.hpp>
+#include <component/snake_apple.hpp>
+#include <component/snake_autopilot.hpp>
+#include <component/snake_owner.hpp>
+#include <component/snake_part.hpp>
+#include <component/snake_part_head.hpp>
+#include <component/snake_boundary_2d.hpp>
+
+#include <system/snake_cycle.hpp>
+#include <system/snake_direction.hpp>
+#include <system/snake_grid.hpp>
+#include <system/resource.hpp>
+#include <system/system_access.hpp>
+#include <util/bitset.hpp>
+#include <util/worker_pool.hpp>
+
+// Steers every snake head that has a SnakeAutopilot by writing its KeyControl
+// (or the KeyControl resource if the head has none; of several such heads, the
+// last in entity order has its way). Each decision searches
+// breadth-first from the head to the nearest apple, then only takes the first
+// step of that path if the tail can still be reached from there afterwards.
+// Heads with the HAMILTONIAN_CYCLE policy instead follow the board's cycle
+// (see snake_cycle.hpp) and only cut across it towards the apple while the cut
+// stays clear of the tail, which fills the board given enough time. On boards
+// without a cycle they fall back to the shortest path policy.
+//
+// Like key presses, decisions take effect on the next gameplay iterate(), so
+// list this system after the gameplay one, in a SystemPipeline or through
+// RuntimeSystems::connect(), and keep heads below half a slot per tick (see
+// TICK_UNIT_TRAVELLED in main.cpp).
+namespace SnakeAutopilotSystem
+{
+    using SnakeGameplaySystem::Direction;
+
+    using Access = SystemAccess<Reads<Position, SnakePart, SnakePartHead, SnakeOwner, SnakeApple, SnakeBoundary2D>,
+                                Writes<KeyControl, SnakeAutopilot>>;
+
+    // Snapshot of the board as bitsets, shared read-only by every decision of a tick.
+    struct Occupancy
+    {
+        long width = 0L;
+        long height = 0L;
+        Bitset blocked; // snake heads and bodies
+        Bitset apples;
+        Bitset pointed; // slots some part points at; a part in an unpointed slot is a tail
+        std::vector<long> appleSlots;
+        long occupiedCount = 0L;
+    }; // struct Occupancy
+
+    // Scratch space of one search, reused so a decision does not allocate. One per thread.
+    struct Planner
+    {
+        Bitset visited;
+        std::vector<long> frontier;
+        std::vector<Direction> firstSteps; // first step from the head towards frontier[i]
+    }; // struct Planner
+
+    static void iterate(entt::registry &reg);
+    static void update(entt::registry &reg);
+
+    // Direction for the head in headIndex, or NO_DIRECTION if every neighbour is blocked.
+    // tailIndex is -1 for a snake without a body.
+    static Direction decide(const Occupancy &occupancy, Planner &planner, const long &headIndex, const long &tailIndex);
+    // Same, following the cycle and taking shortcuts along it towards the nearest apple.
+    static Direction decide_on_cycle(const Occupancy &occupancy, const SnakeGameplaySystem::HamiltonianCycle &cycle, const long &headIndex, const long &tailIndex);
+
+    namespace Detail
+    {
+        using namespace SnakeGameplaySystem::Detail;
+
+        struct Pilot
+        {
+            entt::entity head;
+            long headIndex;
+            long tailIndex; // -1 if there is no tail to follow
+            bool hasFoundTail;
+            SnakeAutopilot::Policy policy;
+            KeyControl *keyControl; // maybe shared with other pilots
+            Direction direction;    // decided, NO_DIRECTION if nothing is free
+        }; // struct Pilot
+
+        struct State
+        {
+            Occupancy occupancy;
+            std::vector<Planner> planners;
+            std::vector<Pilot> pilots; // sorted by head entity
+            std::shared_ptr<const SnakeGameplaySystem::HamiltonianCycle> cycle;
+        }; // struct State
+
+        static State &get_state(entt::registry &reg)
+        {
+            return Resource::get_or_emplace<State>(reg);
+        }
+
+        static bool get_slot(const Occupancy &occupancy, const Position &pos, long *index)
+        {
+            const long x = get_column_from_pos(pos.x);
+            const long y = get_row_from_pos(pos.y, occupancy.height);
+            const bool isInBounds = x >= 0L && y >= 0L && x < occupancy.width && y < occupancy.height;
+            *index = isInBounds ? y * occupancy.width + x : -1L;
+            return isInBounds;
+        }
+
+        static bool step(const Occupancy &occupancy, const long &index, const Direction &direction, long *next)
+        {
+            const long x = index % occupancy.width + DIRECTION_DX[direction];
+            const long y = index / occupancy.width + DIRECTION_DY[direction];
+            *next = y * occupancy.width + x;
+            return x >= 0L && y >= 0L && x < occupancy.width && y < occupancy.height;
+        }
+
+        // Breadth-first search from `from`, calling isGoal on every newly reached slot. The tail
+        // counts as free since it moves out of the way. Returns the first step towards the goal.
+        template <typename IsGoal>
+        static Direction search(const Occupancy &occupancy, Planner &planner, const long &from, const long &tailIndex, IsGoal &&isGoal)
+        {
+            planner.visited.clear();
+            planner.frontier.clear();
+            planner.firstSteps.clear();
+            planner.visited.set(from);
+            planner.frontier.push_back(from);
+            planner.firstSteps.push_back(Direction::NO_DIRECTION);
+            for (size_t i = 0U; i < planner.frontier.size(); i++)
+            {
+                const long index = planner.frontier[i];
+                for (const Direction direction : DIRECTIONS)
+                {
+                    long next;
+                    if (!step(occupancy, index, direction, &next))
+                        continue;
+                    if ((occupancy.blocked.test(next) && next != tailIndex) || planner.visited.test_and_set(next))
+                        continue;
+                    const Direction firstStep = i == 0U ? direction : planner.firstSteps[i];
+                    if (isGoal(next))
+                        return firstStep;
+                    planner.frontier.push_back(next);
+                    planner.firstSteps.push_back(firstStep);
+                }
+            }
+            return Direction::NO_DIRECTION;
+        }
+
+        // After stepping into `from`, the old head slot becomes the neck and is still blocked.
+        static bool is_tail_reachable(const Occupancy &occupancy, Planner &planner, const long &from, const long &tailIndex)
+        {
+            if (tailIndex < 0L || from == tailIndex)
+                return true;
+            return search(occupancy, planner, from, tailIndex, [&tailIndex](const long &index)
+                          { return index == tailIndex; }) != Direction::NO_DIRECTION;
+        }
+
+        static void build_occupancy(entt::registry &reg, Occupancy &occupancy)
+        {
+            const SnakeBoundary2D boundary = Resource::get<SnakeBoundary2D>(reg);
+            if (boundary.x != occupancy.width || boundary.y != occupancy.height)
+            {
+                occupancy.width = boundary.x;
+                occupancy.height = boundary.y;
+                occupancy.blocked.resize(occupancy.width * occupancy.height);
+                occupancy.apples.resize(occupancy.width * occupancy.height);
+                occupancy.pointed.resize(occupancy.width * occupancy.height);
+            }
+            occupancy.blocked.clear();
+            occupancy.apples.clear();
+            occupancy.pointed.clear();
+            occupancy.appleSlots.clear();
+            occupancy.occupiedCount = 0L;
+
+            auto snakePartView = reg.view<SnakePart, Position>();
+            for (auto &entity : snakePartView)
+            {
+                long index, next;
+                if (!get_slot(occupancy, snakePartView.get<Position>(entity), &index))
+                    continue;
+                occupancy.blocked.set(index);
+                occupancy.occupiedCount++;
+                const Direction direction = to_direction(snakePartView.get<SnakePart>(entity).currentDirection);
+                if (direction != Direction::NO_DIRECTION && step(occupancy, index, direction, &next))
+                    occupancy.pointed.set(next);
+            }
+            auto snakePartHeadView = reg.view<SnakePartHead, Position>();
+            for (auto &entity : snakePartHeadView)
+            {
+                long index;
+                if (!get_slot(occupancy, snakePartHeadView.get<Position>(entity), &index))
+                    continue;
+                occupancy.blocked.set(index);
+                occupancy.occupiedCount++;
+            }
+            auto appleView = reg.view<SnakeApple, Position>();
+            for (auto &entity : appleView)
+            {
+                long index;
+                if (!get_slot(occupancy, appleView.get<Position>(entity), &index))
+                    continue;
+                occupancy.apples.set(index);
+                occupancy.appleSlots.push_back(index);
+            }
+        }
+
+        // Heads that need a decision: they entered a new slot, or the slot they are heading into got blocked.
+        static void collect_pilots(entt::registry &reg, State &state)
+        {
+            const Occupancy &occupancy = state.occupancy;
+            state.pilots.clear();
+            KeyControl *sharedKeyControl = Resource::find<KeyControl>(reg);
+            auto keyControlView = reg.view<KeyControl>();
+
+            auto pilotView = reg.view<SnakeAutopilot, SnakePartHead, Position>();
+            for (auto &entity : pilotView)
+            {
+                KeyControl *keyControl = keyControlView.contains(entity) ? &keyControlView.get<KeyControl>(entity) : sharedKeyControl;
+                long headIndex, next;
+                if (keyControl == nullptr || !get_slot(occupancy, pilotView.get<Position>(entity), &headIndex))
+                    continue;
+                SnakeAutopilot &autopilot = pilotView.get<SnakeAutopilot>(entity);
+                const Direction direction = to_direction(keyControl->lastMovementKeyDown);
+                const bool isHeadingIntoBlocked = direction == Direction::NO_DIRECTION || !step(occupancy, headIndex, direction, &next) || occupancy.blocked.test(next);
+                if (autopilot.decidedSlot == headIndex && !isHeadingIntoBlocked)
+                    continue;
+                autopilot.decidedSlot = headIndex;
+                state.pilots.push_back(Pilot{entity, headIndex, -1L, false, autopilot.policy, keyControl, Direction::NO_DIRECTION});
+            }
+            if (state.pilots.empty())
+                return;
+            std::sort(state.pilots.begin(), state.pilots.end(), [](const Pilot &a, const Pilot &b)
+                      { return a.head < b.head; });
+
+            // Parts without a SnakeOwner belong to the one snake of a single-player registry.
+            const entt::entity singleHead = reg.view<SnakePartHead>().size() == 1U ? reg.view<SnakePartHead>().front() : entt::entity{entt::null};
+            auto snakePartView = reg.view<SnakePart, Position>();
+            for (auto &entity : snakePartView)
+            {
+                const SnakeOwner *owner = reg.try_get<SnakeOwner>(entity);
+                const entt::entity head = owner != nullptr ? owner->head : singleHead;
+                const auto found = std::lower_bound(state.pilots.begin(), state.pilots.end(), head, [](const Pilot &pilot, const entt::entity &value)
+                                                    { return pilot.head < value; });
+                long index, next;
+                if (found == state.pilots.end() || found->head != head || found->hasFoundTail)
+                    continue;
+                if (!get_slot(occupancy, snakePartView.get<Position>(entity), &index) || occupancy.pointed.test(index))
+                    continue;
+                // A lone part is the neck as well, and stepping into it would be going backwards.
+                found->hasFoundTail = true;
+                const Direction direction = to_direction(snakePartView.get<SnakePart>(entity).currentDirection);
+                if (!(direction != Direction::NO_DIRECTION && step(occupancy, index, direction, &next) && next == found->headIndex))
+                    found->tailIndex = index;
+            }
+        }
+    } // namespace Detail
+
+    static Direction decide(const Occupancy &occupancy, Planner &planner, const long &headIndex, const long &tailIndex)
+    {
+        if (planner.visited.size() != occupancy.width * occupancy.height)
+            planner.visited.resize(occupancy.width * occupancy.height);
+
+        const Direction towardsApple = Detail::search(occupancy, planner, headIndex, tailIndex, [&occupancy](const long &index)
+                                                      { return occupancy.apples.test(index); });
+
+        // The way to the apple first, then any other safe step, then any step at all.
+        Direction fallback = Direction::NO_DIRECTION;
+        const Direction candidates[] = {towardsApple, Direction::UP, Direction::LEFT, Direction::DOWN, Direction::RIGHT};
+        for (const Direction direction : candidates)
+        {
+            long next;
+            if (direction == Direction::NO_DIRECTION || !Detail::step(occupancy, headIndex, direction, &next))
+                continue;
+            if (occupancy.blocked.test(next) && next != tailIndex)
+                continue;
+            if (Detail::is_tail_reachable(occupancy, planner, next, tailIndex))
+                return direction;
+            if (fallback == Direction::NO_DIRECTION)
+                fallback = direction;
+        }
+        return fallback;
+    }
+
+    static Direction decide_on_cycle(const Occupancy &occupancy, const SnakeGameplaySystem::HamiltonianCycle &cycle, const long &headIndex, const long &tailIndex)
+    {
+        // Slots kept between a shortcut and the tail, so growing on the way cannot close the gap.
+        constexpr long TAIL_MARGIN = 3L;
+        const long area = cycle.area();
+        const long tailDistance = tailIndex < 0L ? area : cycle.get_distance(headIndex, tailIndex);
+        long appleDistance = area;
+        for (const long appleIndex : occupancy.appleSlots)
+            appleDistance = std::min(appleDistance, cycle.get_distance(headIndex, appleIndex));
+        // Past half the board the body is too long for shortcuts to pay off safely.
+        const bool isCuttingAllowed = occupancy.occupiedCount * 2L < area;
+
+        // The furthest step along the cycle that neither passes the apple nor reaches the tail.
+        Direction best = Direction::NO_DIRECTION;
+        long bestDistance = 0L;
+        for (const Direction direction : Detail::DIRECTIONS)
+        {
+            long next;
+            if (!Detail::step(occupancy, headIndex, direction, &next))
+                continue;
+            if (occupancy.blocked.test(next) && next != tailIndex)
+                continue;
+            const long distance = cycle.get_distance(headIndex, next);
+            if (distance != 1L && (!isCuttingAllowed || distance > appleDistance || distance + TAIL_MARGIN >= tailDistance))
+                continue;
+            if (distance > bestDistance)
+            {
+                best = direction;
+                bestDistance = distance;
+            }
+        }
+        return best;
+    }
+
+    static void iterate(entt::registry &reg)
+    {
+        if (reg.view<SnakeAutopilot>().empty() || Resource::find<SnakeBoundary2D>(reg) == nullptr)
+            return;
+        Detail::State &state = Detail::get_state(reg);
+        Detail::build_occupancy(reg, state.occupancy);
+        Detail::collect_pilots(reg, state);
+        const Occupancy &occupancy = state.occupancy;
+        const bool isCycleNeeded = std::any_of(state.pilots.begin(), state.pilots.end(), [](const Detail::Pilot &pilot)
+                                               { return pilot.policy == SnakeAutopilot::HAMILTONIAN_CYCLE; });
+        if (isCycleNeeded && (!state.cycle || state.cycle->width() != occupancy.width || state.cycle->height() != occupancy.height))
+            state.cycle = SnakeGameplaySystem::get_hamiltonian_cycle(occupancy.width, occupancy.height);
+
+        // One planner per thread; each takes a contiguous share of the pilots.
+        WorkerPool **workerPool = Resource::find<WorkerPool *>(reg);
+        const long plannerCount = workerPool != nullptr ? static_cast<long>((*workerPool)->get_thread_count()) : 1L;
+        if (static_cast<long>(state.planners.size()) < plannerCount)
+            state.planners.resize(static_cast<size_t>(plannerCount));
+        const long pilotCount = static_cast<long>(state.pilots.size());
+        auto decideShares = [&state, &plannerCount, &pilotCount](const long &begin, const long &end)
+        {
+            for (long share = begin; share < end; share++)
+            {
+                for (long i = share * pilotCount / plannerCount; i < (share + 1L) * pilotCount / plannerCount; i++)
+                {
+                    Detail::Pilot &pilot = state.pilots[i];
+                    pilot.direction = pilot.policy == SnakeAutopilot::HAMILTONIAN_CYCLE && state.cycle
+                                          ? decide_on_cycle(state.occupancy, *state.cycle, pilot.headIndex, pilot.tailIndex)
+                                          : decide(state.occupancy, state.planners[share], pilot.headIndex, pilot.tailIndex);
+                }
+            }
+        };
+        if (workerPool != nullptr)
+            (*workerPool)->parallel_for(plannerCount, decideShares);
+        else
+            decideShares(0L, plannerCount);
+
+        // Pilots may share a KeyControl, so the keys are written here in head order, not by the threads.
+        for (const Detail::Pilot &pilot : state.pilots)
+        {
+            if (pilot.direction != Direction::NO_DIRECTION)
+                pilot.keyControl->lastMovementKeyDown = Detail::DIRECTION_KEY[pilot.direction];
+        }
+    }
+    static void update(entt::registry &reg) { return iterate(reg); }
+} // namespace SnakeAutopilotSystem
+
+#endif // SRC_SYSTEM_SNAKE_AUTOPILOT_SYSTEM_HPP
@@ -0,0 +1,180 @@
+#ifndef SRC_SYSTEM_SNAKE_CYCLE_HPP
+#define SRC_SYSTEM_SNAKE_CYCLE_HPP
+
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <SDL3/SDL_stdinc.h>
+
+namespace SnakeGameplaySystem
+{
+    // Closed path visiting every slot of a board once, each step to an adjacent slot.
+    // One exists when the area is even and the board is at least 2 slots wide and high,
+    // or for the 1x2 and 2x1 boards. Slots are row-major indices like the grids use.
+    class HamiltonianCycle
+    {
+    public:
+        bool build(const long &width, const long &height)
+        {
+            widthCells = width;
+            heightCells = height;
+            slots.clear();
+            if ((width == 1L && height == 2L) || (width == 2L && height == 1L))
+            {
+                slots = {0U, 1U};
+            }
+            else if (width >= 2L && height >= 2L && height % 2L == 0L)
+            {
+                build_rows(width, height, false);
+            }
+            else if (width >= 2L && height >= 2L && width % 2L == 0L)
+            {
+                build_rows(height, width, true);
+            }
+            else
+            {
+                widthCells = heightCells = 0L;
+                return false;
+            }
+            index_positions();
+            return true;
+        }
+
+        // False if the file is missing, is for another board size or does not hold a valid cycle.
+        bool load(const std::string &path, const long &width, const long &height)
+        {
+            std::ifstream file(path, std::ios::binary);
+            Uint32 header[3] = {0U, 0U, 0U};
+            if (!file.read(reinterpret_cast<char *>(header), sizeof(header)) || header[0] != FILE_MAGIC || header[1] != width || header[2] != height)
+                return false;
+            widthCells = width;
+            heightCells = height;
+            slots.resize(static_cast<size_t>(width * height));
+            if (!file.read(reinterpret_cast<char *>(slots.data()), static_cast<std::streamsize>(slots.size() * sizeof(Uint32))) || !is_valid())
+            {
+                slots.clear();
+                widthCells = heightCells = 0L;
+                return false;
+            }
+            index_positions();
+            return true;
+        }
+        bool save(const std::string &path) const
+        {
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            const Uint32 header[3] = {FILE_MAGIC, static_cast<Uint32>(widthCells), static_cast<Uint32>(heightCells)};
+            file.write(reinterpret_cast<const char *>(header), sizeof(header));
+            file.write(reinterpret_cast<const char *>(slots.data()), static_cast<std::streamsize>(slots.size() * sizeof(Uint32)));
+            return static_cast<bool>(file);
+        }
+
+        bool empty() const { return slots.empty(); }
+        long width() const { return widthCells; }
+        long height() const { return heightCells; }
+        long area() const { return static_cast<long>(slots.size()); }
+
+        long get_position(const long &slot) const { return positions[slot]; }
+        long get_slot(const long &position) const { return slots[position]; }
+        // Steps forward along the cycle from one slot to the other.
+        long get_distance(const long &fromSlot, const long &toSlot) const
+        {
+            const long distance = get_position(toSlot) - get_position(fromSlot);
+            return distance < 0L ? distance + area() : distance;
+        }
+
+        bool operator==(const HamiltonianCycle &other) const { return widthCells == other.widthCells && slots == other.slots; }
+
+    private:
+        static constexpr Uint32 FILE_MAGIC = 0x31594353U; // "SCY1"
+
+        // Column 0 is the way back up; the other columns are swept row by row.
+        void build_rows(const long &across, const long &down, const bool &isTransposed)
+        {
+            auto push = [this, &isTransposed](const long &a, const long &d)
+            { slots.push_back(static_cast<Uint32>(isTransposed ? a * widthCells + d : d * widthCells + a)); };
+            push(0L, 0L);
+            for (long d = 0L; d < down; d++)
+            {
+                for (long i = 1L; i < across; i++)
+                    push(d % 2L == 0L ? i : across - i, d);
+            }
+            for (long d = down - 1L; d >= 1L; d--)
+                push(0L, d);
+        }
+
+        void index_positions()
+        {
+            positions.assign(slots.size(), 0U);
+            for (size_t position = 0U; position < slots.size(); position++)
+                positions[slots[position]] = static_cast<Uint32>(position);
+        }
+
+        bool is_valid() const
+        {
+            std::vector<bool> isVisited(slots.size(), false);
+            for (size_t position = 0U; position < slots.size(); position++)
+            {
+                const long slot = slots[position];
+                const long next = slots[(position + 1U) % slots.size()];
+                if (slot >= area() || isVisited[slot])
+                    return false;
+                isVisited[slot] = true;
+                const long dx = slot % widthCells - next % widthCells;
+                const long dy = slot / widthCells - next / widthCells;
+                if (dx * dx + dy * dy != 1L)
+                    return false;
+            }
+            return true;
+        }
+
+        std::vector<Uint32> slots;     // slot at each position along the cycle
+        std::vector<Uint32> positions; // position of each slot along the cycle
+        long widthCells = 0L;
+        long heightCells = 0L;
+    }; // class HamiltonianCycle
+
+    namespace Detail
+    {
+        struct CycleCache
+        {
+            static inline std::mutex mutex;
+            static inline std::string directory;
+            static inline std::map<std::pair<long, long>, std::shared_ptr<const HamiltonianCycle>> cycles;
+        }; // struct CycleCache
+    } // namespace Detail
+
+    // Cycles are also saved to and loaded from this directory; empty (the default) keeps them in memory only.
+    static void set_cycle_cache_directory(const std::string &directory)
+    {
+        std::lock_guard<std::mutex> lock(Detail::CycleCache::mutex);
+        Detail::CycleCache::directory = directory;
+    }
+
+    // Built once per board size, then shared. nullptr if the board has no Hamiltonian cycle.
+    static std::shared_ptr<const HamiltonianCycle> get_hamiltonian_cycle(const long &width, const long &height)
+    {
+        std::lock_guard<std::mutex> lock(Detail::CycleCache::mutex);
+        auto found = Detail::CycleCache::cycles.find({width, height});
+        if (found != Detail::CycleCache::cycles.end())
+            return found->second;
+
+        auto cycle = std::make_shared<HamiltonianCycle>();
+        const std::string path = Detail::CycleCache::directory.empty() ? std::string() : Detail::CycleCache::directory + "/cycle_" + std::to_string(width) + "x" + std::to_string(height) + ".bin";
+        if (path.empty() || !cycle->load(path, width, height))
+        {
+            if (!cycle->build(width, height))
+                cycle = nullptr;
+            else if (!path.empty())
+                cycle->save(path);
+        }
+        Detail::CycleCache::cycles[{width, height}] = cycle;
+        return cycle;
+    }
+} // namespace SnakeGameplaySystem
+
+#endif // SRC_SYSTEM_SNAKE_CYCLE_HPP
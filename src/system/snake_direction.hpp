@@ -0,0 +1,65 @@
+#ifndef SRC_SYSTEM_SNAKE_DIRECTION_HPP
+#define SRC_SYSTEM_SNAKE_DIRECTION_HPP
+
+#include <array>
+
+#include <SDL3/SDL_stdinc.h>
+
+namespace SnakeGameplaySystem
+{
+    // Compact form of the 'w', 'a', 's', 'd' keys stored in SnakePart and KeyControl.
+    // Every table below is indexed by it.
+    enum Direction : Uint8
+    {
+        UP = 0U,
+        LEFT = 1U,
+        DOWN = 2U,
+        RIGHT = 3U,
+        NO_DIRECTION = 4U,
+    }; // enum Direction
+
+    namespace Detail
+    {
+        static constexpr Direction DIRECTIONS[] = {Direction::UP, Direction::LEFT, Direction::DOWN, Direction::RIGHT};
+
+        static constexpr char DIRECTION_KEY[] = {'w', 'a', 's', 'd', '\t'};
+        static constexpr Direction OPPOSITE_DIRECTION[] = {Direction::DOWN, Direction::RIGHT, Direction::UP, Direction::LEFT, Direction::NO_DIRECTION};
+
+        // One step in slots; rows grow downwards like get_map().
+        static constexpr long DIRECTION_DX[] = {0L, -1L, 0L, 1L, 0L};
+        static constexpr long DIRECTION_DY[] = {-1L, 0L, 1L, 0L, 0L};
+
+        // One step in Position space, where y grows upwards. Also the sign of the velocity.
+        static constexpr float DIRECTION_POS_DX[] = {0.0f, -1.0f, 0.0f, 1.0f, 0.0f};
+        static constexpr float DIRECTION_POS_DY[] = {1.0f, 0.0f, -1.0f, 0.0f, 0.0f};
+
+        // Direction travelled between two slots, indexed by [sign(dy) + 1][sign(dx) + 1].
+        // Up wins over left, left over down and down over right when both axes changed.
+        static constexpr Direction TRAVELLED_DIRECTION[3][3] = {
+            {Direction::UP, Direction::UP, Direction::UP},
+            {Direction::LEFT, Direction::NO_DIRECTION, Direction::RIGHT},
+            {Direction::LEFT, Direction::DOWN, Direction::DOWN},
+        };
+
+        static constexpr std::array<Direction, 256> make_direction_from_key()
+        {
+            std::array<Direction, 256> ret{};
+            for (auto &direction : ret)
+                direction = Direction::NO_DIRECTION;
+            for (const Direction direction : DIRECTIONS)
+                ret[static_cast<unsigned char>(DIRECTION_KEY[direction])] = direction;
+            return ret;
+        }
+        static constexpr std::array<Direction, 256> DIRECTION_FROM_KEY = make_direction_from_key();
+
+        static constexpr Direction to_direction(const char &key) { return DIRECTION_FROM_KEY[static_cast<unsigned char>(key)]; }
+        static constexpr long get_index_offset(const Direction &direction, const long &width) { return DIRECTION_DY[direction] * width + DIRECTION_DX[direction]; }
+        static constexpr long get_sign(const long &value) { return (value > 0L) - (value < 0L); }
+        static constexpr Direction get_travelled_direction(const long &fromX, const long &fromY, const long &toX, const long &toY)
+        {
+            return TRAVELLED_DIRECTION[get_sign(toY - fromY) + 1L][get_sign(toX - fromX) + 1L];
+        }
+    } // namespace Detail
+} // namespace SnakeGameplaySystem
+
+#endif // SRC_SYSTEM_SNAKE_DIRECTION_HPP
@@ -1,6 +1,8 @@
 #ifndef SRC_SYSTEM_SNAKE_DISCRETE_VECTOR_HPP
 #define SRC_SYSTEM_SNAKE_DISCRETE_VECTOR_HPP
 
+#include <algorithm>
+#include <list>
 #include <vector>
 #include <string>
 
@@ -10,26 +12,31 @@
 #include <entt/entt.hpp>
 #include <sigslot/signal.hpp>
 
+#include <component/delta_time.hpp>
 #include <component/velocity.hpp>
 #include <component/key_control.hpp>
 #include <component/snake_apple.hpp>
 #include <component/snake_part.hpp>
 #include <component/snake_part_head.hpp>
 #include <component/snake_boundary_2d.hpp>
+#include <component/random_state.hpp>
+
+#include <system/change_tracker.hpp>
+#include <system/command_buffer.hpp>
+#include <system/snake_direction.hpp>
+#include <system/snake_grid.hpp>
+#include <system/snake_random.hpp>
+#include <system/resource.hpp>
+#include <system/system_access.hpp>
 
 namespace SnakeGameplaySystem
 {
-    enum MapSlotState : Uint8
+    enum GameStatus : Uint8
     {
-        EMPTY = 0b0000U,
-        SNAKE_HEAD = 0b0001U,
-        SNAKE_BODY = 0b0010U,
-        APPLE = 0b0100U,
-
-        ENUM_END = 0b1111U,
-    }; // enum MapSlotState
-
-    inline std::vector<std::vector<MapSlotState>> previousMap;
+        PLAYING = 0U,
+        WON = 1U,
+        LOST = 2U,
+    }; // enum GameStatus
 
     namespace Control
     {
@@ -49,728 +56,772 @@ namespace SnakeGameplaySystem
 
     namespace Detail
     {
-        static bool is_going_backwards(entt::registry &reg, const char &directionToGo);
-        static void do_trailing(entt::registry &reg, const bool &isAteApple);
-        static bool apple_update(entt::registry &reg);
+        template <typename Grid>
+        struct Engine;
     } // namespace Detail
 
+    // Variant for boards whose size is known at compile time, e.g. Fixed<20, 20>.
+    // The board is a std::array, so a tick does not touch the heap.
+    template <int WIDTH, int HEIGHT>
+    using Fixed = Detail::Engine<FixedGrid<WIDTH, HEIGHT>>;
+
+    // Boards sized at run time are chunked, so huge boards cost what is on them.
+    // get_map() still builds the whole board; prefer get_board() for large ones.
+    static const ChunkedGrid &get_board(entt::registry &reg);
+    // Brings the board's byte buffer up to date and returns it, without copying it out.
+    // The buffer is only kept once asked for, and stays where it is until the board is resized.
+    static BoardView get_board_view(entt::registry &reg);
     static std::vector<std::vector<MapSlotState>> get_map(entt::registry &reg);
     static bool is_game_success(entt::registry &reg);
     static bool is_game_failure(entt::registry &reg);
+    static GameStatus get_status(entt::registry &reg);
     static unsigned long get_score(entt::registry &reg);
     static bool is_speeding_up(entt::registry &reg);
 
-    static void iterate(entt::registry &reg)
+    // The scene every game starts from: clears the registry, keeping its storage, sets the
+    // resources and puts the apple in the middle of the board and the head in the third
+    // column a row below it, heading right. Apples respawn from `seed`. Returns the head,
+    // for the caller to add to before calling init(). The board must be at least
+    // MIN_SCENE_WIDTH wide, or the head starts outside of it.
+    static constexpr int MIN_SCENE_WIDTH = 3;
+    static entt::entity spawn_scene(entt::registry &reg, const int &width, const int &height, const Uint64 &seed,
+                                    const Uint64 &tickPeriodMs, const float &speed, const float &speedUpFactor);
+
+    namespace Detail
     {
-        if (is_game_success(reg))
-            return;
-        if (is_game_failure(reg))
-            return;
+        template <typename Grid>
+        struct Engine
+        {
+            // Moves the snake, grows it and respawns the apple. Parts and apples that come and go
+            // are recorded in the CommandBuffer: run CommandBuffer::iterate after it, or call update().
+            using Access = SystemAccess<Reads<KeyControl, SnakeBoundary2D, SnakePartHead>,
+                                        Writes<Position, Velocity, SnakePart, SnakeApple, RandomState, CommandBuffer, ChangeTracker>>;
+
+            // Row-major copy of the board behind get_board_view(), patched in the slots the ChangeTracker
+            // reports, or where the snake and apple were and are when it cannot tell.
+            struct Observation
+            {
+                std::vector<Uint8> slots;
+                std::vector<long> written;     // slots that may be non-empty in `slots`, some maybe twice
+                std::vector<long> nextWritten; // scratch for the next refresh
+                long width = 0L;
+                long height = 0L;
+                Uint64 generation = 0U;
+                ChangeTracker::Cursor cursor;
+            }; // struct Observation
+
+            // Slot and bits an entity put on the board, so they can be taken off again.
+            struct Placement
+            {
+                entt::entity entity; // entt::null if the entity with this index put nothing there
+                long index;
+                Uint8 bits;
+            }; // struct Placement
 
-        const bool ateApple = Detail::apple_update(reg);
+            struct State
+            {
+                Grid board;
+                std::vector<Placement> placements; // by entity index
+                ChangeTracker::Cursor boardCursor; // as of the last time the board was brought up to date
+                long previousHeadX = -1L;          // snake head slot as of the last iterate(), -1 if none
+                long previousHeadY = -1L;
+                long grownNeckIndex = -1L; // slot of the part grown this tick, until the CommandBuffer adds it
+                Direction grownNeckDirection = Direction::NO_DIRECTION;
+                Observation observation;
+                std::vector<entt::entity> spareParts;    // entities without components, for the parts the snake grows
+                GameStatus status = GameStatus::PLAYING; // as found by the last iterate() or init()
+            }; // struct State
+
+            // init() makes this many spare part entities, so growing the snake only adds components.
+            // Parts grown once they run out are created by the CommandBuffer with their components.
+            static constexpr long SPARE_PART_BATCH = 64L;
+            // Huge boards reserve up to this many parts and grow the rest as the snake does.
+            static constexpr long MAX_RESERVED_PARTS = 1L << 16;
+
+            struct Trail
+            {
+                bool isMoving;
+                Direction direction; // direction the head travelled in
+                long spawnX;    // slot the head left, where the new neck goes
+                long spawnY;
+            }; // struct Trail
 
-        auto keyControlView = reg.view<KeyControl>();
-        SDL_assert(keyControlView.size() == 1);
-        KeyControl keyControl = reg.get<KeyControl>(keyControlView.front());
+            static void iterate(entt::registry &reg)
+            {
+                State &state = get_state(reg);
+                Resource::get<ChangeTracker>(reg).next_tick(reg);
+                build_board(reg, state);
+                state.status = get_status(reg, state.board);
+                if (state.status != GameStatus::PLAYING)
+                    return;
 
-        auto snakeHeadView = reg.view<Velocity, SnakePartHead>();
-        SDL_assert(snakeHeadView.storage<SnakePartHead>()->size() == 1);
-        for (auto &entity : snakeHeadView)
-        {
-            Velocity &vel = snakeHeadView.get<Velocity>(entity);
-            SnakePartHead &headPart = snakeHeadView.get<SnakePartHead>(entity);
-            switch (keyControl.lastMovementKeyDown)
-            {
-            case 'w':
-                if (Detail::is_going_backwards(reg, 'w'))
-                    break;
-                vel.x = 0.0f;
-                vel.y = headPart.speed;
-                if (keyControl.isShiftKeyDown)
-                    vel.y *= headPart.speedUpFactor;
-                break;
-            case 'a':
-                if (Detail::is_going_backwards(reg, 'a'))
-                    break;
-                vel.x = -1.0f * headPart.speed;
-                if (keyControl.isShiftKeyDown)
-                    vel.x *= headPart.speedUpFactor;
-                vel.y = 0.0f;
-                break;
-            case 's':
-                if (Detail::is_going_backwards(reg, 's'))
-                    break;
-                vel.x = 0.0f;
-                vel.y = -1.0f * headPart.speed;
-                if (keyControl.isShiftKeyDown)
-                    vel.y *= headPart.speedUpFactor;
-                break;
-            case 'd':
-                if (Detail::is_going_backwards(reg, 'd'))
-                    break;
-                vel.x = headPart.speed;
-                if (keyControl.isShiftKeyDown)
-                    vel.x *= headPart.speedUpFactor;
-                vel.y = 0.0f;
-                break;
-            default:
-                break;
-            }
-        }
-        previousMap = get_map(reg);
+                apple_update(reg, state);
 
-        const SnakeBoundary2D boundary = reg.get<SnakeBoundary2D>(reg.view<SnakeBoundary2D>().front());
-        for (int i = 0; i < previousMap.size(); i++)
-        {
-            for (int j = 0; j < previousMap[i].size(); j++)
-            {
-                if ((previousMap[i][j] & MapSlotState::SNAKE_HEAD) && (previousMap[i][j] & MapSlotState::SNAKE_BODY))
+                const KeyControl keyControl = Resource::get<KeyControl>(reg);
+
+                auto snakeHeadView = reg.view<Velocity, SnakePartHead>();
+                SDL_assert(snakeHeadView.storage<SnakePartHead>()->size() == 1);
+                const Direction direction = to_direction(keyControl.lastMovementKeyDown);
+                for (auto &entity : snakeHeadView)
+                {
+                    if (direction == Direction::NO_DIRECTION || is_going_backwards(reg, state.board, direction, state.grownNeckIndex, state.grownNeckDirection))
+                        continue;
+                    Velocity &vel = snakeHeadView.get<Velocity>(entity);
+                    const SnakePartHead &headPart = snakeHeadView.get<SnakePartHead>(entity);
+                    const float speed = headPart.speed * (keyControl.isShiftKeyDown ? headPart.speedUpFactor : 1.0f);
+                    vel.x = DIRECTION_POS_DX[direction] * speed;
+                    vel.y = DIRECTION_POS_DY[direction] * speed;
+                }
+
+                long x, y;
+                if (!get_head_cell(reg, state.board, &x, &y))
                 {
+                    state.previousHeadX = state.previousHeadY = -1L;
+                    return;
+                }
+                state.previousHeadX = x;
+                state.previousHeadY = y;
+
+                const long index = state.board.to_index(x, y);
+                if ((state.board.get(index) & MapSlotState::SNAKE_HEAD) && (state.board.get(index) & MapSlotState::SNAKE_BODY))
+                {
+                    CommandBuffer &commandBuffer = Resource::get_or_emplace<CommandBuffer>(reg);
                     auto snakePartView = reg.view<SnakePart>();
                     for (auto &entity : snakePartView)
                     {
                         const Position pos = reg.get<Position>(entity);
                         long xIndex, yIndex;
-                        Util::get_index_from_pos(pos, &xIndex, &yIndex, boundary.y);
-                        if (xIndex == j && yIndex == i)
-                            reg.destroy(entity);
+                        state.board.get_index_from_pos(pos, &xIndex, &yIndex);
+                        if (xIndex == x && yIndex == y)
+                        {
+                            commandBuffer.destroy(entity);
+                            lift(state, entity);
+                        }
                     }
                 }
             }
-        }
-    }
-    static void update(entt::registry &reg) { return iterate(reg); }
-
-    static bool init(entt::registry &reg)
-    {
-        {
-            auto snakeHeadView = reg.view<SnakePartHead>();
-            if (snakeHeadView.empty())
-                return false;
-        }
-        previousMap = get_map(reg);
-        return true;
-    }
-    static bool init(sigslot::signal<entt::registry &> &signal, entt::registry &reg)
-    {
-        static std::list<sigslot::signal<entt::registry &> *> regSignalArray;
-        bool ret = true;
-        for (auto connectedSignal : regSignalArray)
-        {
-            if (connectedSignal == &signal)
+            // The tick with what it recorded applied, for callers that do not run CommandBuffer::iterate.
+            static void update(entt::registry &reg)
             {
-                ret = false;
-                break;
+                iterate(reg);
+                CommandBuffer::flush(reg);
             }
-        }
-        if (ret)
-        {
-            signal.connect(SnakeGameplaySystem::iterate);
-            regSignalArray.push_back(&signal);
-            init(reg);
-        }
-        return ret;
-    }
 
-    static std::vector<std::vector<MapSlotState>> get_map(entt::registry &reg)
-    {
-        auto snakeBoundaryView = reg.view<SnakeBoundary2D>();
-        SDL_assert(snakeBoundaryView.size() == 1);
-        const SnakeBoundary2D boundary = reg.get<SnakeBoundary2D>(snakeBoundaryView.front());
-
-        const int xSize = boundary.x;
-        const int ySize = boundary.y;
-
-        std::vector<std::vector<MapSlotState>> ret(ySize, std::vector<MapSlotState>(xSize, MapSlotState::EMPTY));
-
-        auto snakePartView = reg.view<SnakePart, Position>();
-        for (auto &entity : snakePartView)
-        {
-            const Position &pos = snakePartView.get<Position>(entity);
-            long xIndex, yIndex;
-            SnakeGameplaySystem::Util::get_index_from_pos(pos, &xIndex, &yIndex, boundary.y);
-            if (xIndex >= 0 && yIndex >= 0 && yIndex < ret.size() && xIndex < ret[yIndex].size())
-                ret[yIndex][xIndex] = MapSlotState::SNAKE_BODY;
-        }
+            static bool init(entt::registry &reg)
+            {
+                {
+                    auto snakeHeadView = reg.view<SnakePartHead>();
+                    if (snakeHeadView.empty())
+                        return false;
+                }
+                State &state = get_state(reg);
+                build_board(reg, state);
+                state.status = get_status(reg, state.board);
+                get_head_cell(reg, state.board, &state.previousHeadX, &state.previousHeadY);
+                reserve(reg, state);
+                fill_spare_parts(reg, state);
+                return true;
+            }
 
-        auto snakePartHeadView = reg.view<SnakePartHead, Position>();
-        for (auto &entity : snakePartHeadView)
-        {
-            const Position &pos = snakePartView.get<Position>(entity);
-            long xIndex, yIndex;
-            SnakeGameplaySystem::Util::get_index_from_pos(pos, &xIndex, &yIndex, boundary.y);
-            if (xIndex >= 0 && yIndex >= 0 && yIndex < ret.size() && xIndex < ret[yIndex].size())
+            // Board as of now; the reference stays valid until the next call on this registry.
+            static const Grid &get_board(entt::registry &reg)
             {
-                Uint8 entry = static_cast<Uint8>(ret[yIndex][xIndex]) | MapSlotState::SNAKE_HEAD;
-                ret[yIndex][xIndex] = static_cast<MapSlotState>(entry);
+                State &state = get_state(reg);
+                build_board(reg, state);
+                return state.board;
             }
-        }
+            static BoardView get_board_view(entt::registry &reg)
+            {
+                State &state = get_state(reg);
+                build_board(reg, state);
+                refresh_observation(reg, state.board, state.observation);
+                const Observation &observation = state.observation;
+                return BoardView{observation.slots.data(), observation.width, observation.height, observation.width, observation.generation};
+            }
+            static bool is_game_success(entt::registry &reg) { return is_game_success(get_board(reg)); }
+            static bool is_game_failure(entt::registry &reg)
+            {
+                State &state = get_state(reg);
+                build_board(reg, state);
+                return is_game_failure(reg, state.board);
+            }
+            // Outcome as the last iterate() or init() found it, without rebuilding the board.
+            // The move that ends the game shows up at the next iterate(), which does nothing else.
+            static GameStatus get_status(entt::registry &reg) { return get_state(reg).status; }
 
-        auto appleView = reg.view<SnakeApple, Position>();
-        for (auto &entity : appleView)
-        {
-            const Position &pos = appleView.get<Position>(entity);
-            long xIndex, yIndex;
-            SnakeGameplaySystem::Util::get_index_from_pos(pos, &xIndex, &yIndex, boundary.y);
-            if (xIndex >= 0 && yIndex >= 0 && yIndex < ret.size() && xIndex < ret[yIndex].size())
+            static State &get_state(entt::registry &reg)
             {
-                Uint8 entry = static_cast<Uint8>(ret[yIndex][xIndex]) | MapSlotState::APPLE;
-                ret[yIndex][xIndex] = static_cast<MapSlotState>(entry);
+                if (State *state = Resource::find<State>(reg))
+                    return *state;
+                ChangeTracker::connect(reg);
+                return Resource::get_or_emplace<State>(reg);
             }
-        }
 
-        return ret;
-    }
-    static bool is_game_success(entt::registry &reg)
-    {
-        auto map = get_map(reg);
-        for (int i = 0; i < map.size(); i++)
-        {
-            for (int j = 0; j < map[i].size(); j++)
+            // Moves what the entities the ChangeTracker saw change put on the board, or rebuilds
+            // it from the registry when the tracker cannot tell or the board was resized.
+            static void build_board(entt::registry &reg, State &state)
             {
-                if (map[i][j] == MapSlotState::EMPTY || map[i][j] == MapSlotState::APPLE)
-                    return false;
+                const SnakeBoundary2D boundary = Resource::get<SnakeBoundary2D>(reg);
+                const ChangeTracker &changeTracker = Resource::get<ChangeTracker>(reg);
+                Grid &board = state.board;
+                auto replace = [&reg, &state](const entt::entity &entity)
+                { place(reg, state, entity); };
+                if (board.width() == boundary.x && board.height() == boundary.y && changeTracker.for_each_changed_entity(state.boardCursor, replace))
+                    return;
+                state.boardCursor = changeTracker.get_cursor();
+                board.reset(boundary.x, boundary.y);
+                for (Placement &placement : state.placements)
+                    placement.entity = entt::null;
+
+                for (auto &entity : reg.view<SnakePart, Position>())
+                    place(reg, state, entity);
+                for (auto &entity : reg.view<SnakePartHead, Position>())
+                    place(reg, state, entity);
+                for (auto &entity : reg.view<SnakeApple, Position>())
+                    place(reg, state, entity);
+            }
+            static Placement &get_placement(State &state, const entt::entity &entity)
+            {
+                const size_t id = static_cast<size_t>(entt::to_entity(entity));
+                if (id >= state.placements.size())
+                    state.placements.resize(id + 1U, Placement{entt::null, -1L, 0U});
+                return state.placements[id];
+            }
+            // Takes off the board what the entity put there.
+            static void lift(State &state, const entt::entity &entity)
+            {
+                Placement &placement = get_placement(state, entity);
+                if (placement.entity != entity)
+                    return;
+                state.board.remove(placement.index, placement.bits);
+                placement.entity = entt::null;
+            }
+            // Puts bits in the slot for the entity, in place of what it put on the board before.
+            static void put(State &state, const entt::entity &entity, const long &index, const Uint8 &bits)
+            {
+                lift(state, entity);
+                state.board.add(index, bits);
+                get_placement(state, entity) = Placement{entity, index, bits};
+            }
+            // Brings what the entity puts on the board up to date with the registry.
+            static void place(entt::registry &reg, State &state, const entt::entity &entity)
+            {
+                lift(state, entity);
+                if (!reg.valid(entity))
+                    return;
+                const Position *pos = reg.try_get<Position>(entity);
+                if (pos == nullptr)
+                    return;
+                Uint8 bits = MapSlotState::EMPTY;
+                if (reg.all_of<SnakePart>(entity))
+                    bits |= MapSlotState::SNAKE_BODY;
+                if (reg.all_of<SnakePartHead>(entity))
+                    bits |= MapSlotState::SNAKE_HEAD;
+                if (reg.all_of<SnakeApple>(entity))
+                    bits |= MapSlotState::APPLE;
+                long xIndex, yIndex;
+                state.board.get_index_from_pos(*pos, &xIndex, &yIndex);
+                if (bits != MapSlotState::EMPTY && state.board.is_in_bounds(xIndex, yIndex))
+                    put(state, entity, state.board.to_index(xIndex, yIndex), bits);
             }
-        }
-        return true;
-    }
-    static bool is_game_failure(entt::registry &reg)
-    {
-        auto snakeHeadPos = reg.get<Position>(reg.view<SnakePartHead, Position>().front());
-        auto boundary = reg.get<SnakeBoundary2D>(reg.view<SnakeBoundary2D>().front());
-        if (snakeHeadPos.x < 0.0f || snakeHeadPos.x >= boundary.x || snakeHeadPos.y < 0.0f || snakeHeadPos.y >= boundary.y)
-            return true;
 
-        auto map = get_map(reg);
-        for (int i = 0; i < map.size(); i++)
-        {
-            for (int j = 0; j < map[i].size(); j++)
+            // Costs what changed since the last refresh, or what is on the board if the
+            // ChangeTracker cannot tell, rather than the board's area.
+            static void refresh_observation(entt::registry &reg, const Grid &board, Observation &observation)
+            {
+                bool isChanged = false;
+                if (observation.width != board.width() || observation.height != board.height())
+                {
+                    observation.width = board.width();
+                    observation.height = board.height();
+                    observation.slots.assign(static_cast<size_t>(board.area()), MapSlotState::EMPTY);
+                    observation.written.clear();
+                    observation.cursor = ChangeTracker::Cursor{};
+                    isChanged = true;
+                }
+
+                auto patch = [&board, &observation, &isChanged](const long &index)
+                {
+                    if (index >= board.area())
+                        return;
+                    const Uint8 slot = board.get(index);
+                    if (observation.slots[index] == slot)
+                        return;
+                    if (observation.slots[index] == MapSlotState::EMPTY)
+                        note_written(observation, index);
+                    observation.slots[index] = slot;
+                    isChanged = true;
+                };
+                if (!Resource::get<ChangeTracker>(reg).for_each_dirty_cell(observation.cursor, patch))
+                    rewrite_observation(reg, board, observation, &isChanged);
+                if (isChanged)
+                    observation.generation++;
+            }
+            static void rewrite_observation(entt::registry &reg, const Grid &board, Observation &observation, bool *isChanged)
             {
-                if ((static_cast<Uint8>(map[i][j]) & SNAKE_HEAD) && (static_cast<Uint8>(map[i][j]) & SNAKE_BODY))
-                { // TODO: refactor below and also the same code to find tail in Detail::do_trailing()
-                    auto snakePartView = reg.view<Position, SnakePart>();
-                    struct Index
+                for (const long index : observation.written)
+                {
+                    if (board.get(index) == MapSlotState::EMPTY && observation.slots[index] != MapSlotState::EMPTY)
                     {
-                        explicit Index(const int &_i, const int &_j) : i(_i), j(_j) {}
-                        int i;
-                        int j;
-                    }; // struct Index
-                    std::vector<Index> indexVec;
-                    for (const auto &entity : snakePartView)
+                        observation.slots[index] = MapSlotState::EMPTY;
+                        *isChanged = true;
+                    }
+                }
+
+                observation.nextWritten.clear();
+                auto write = [&board, &observation, &isChanged](const Position &pos)
+                {
+                    long xIndex, yIndex;
+                    board.get_index_from_pos(pos, &xIndex, &yIndex);
+                    if (!board.is_in_bounds(xIndex, yIndex))
+                        return;
+                    const long index = board.to_index(xIndex, yIndex);
+                    const Uint8 slot = board.get(index);
+                    if (observation.slots[index] != slot)
                     {
-                        const bool isValid = reg.all_of<SnakePart, Position>(entity);
-                        SDL_assert(isValid);
-                        Position pos = reg.get<Position>(entity);
-                        const SnakePart snakePart = reg.get<SnakePart>(entity);
-                        switch (snakePart.currentDirection)
-                        {
-                        case 'w':
-                        {
-                            pos.y += 1.0f;
-                            long xIndex, yIndex;
-                            Util::get_index_from_pos(pos, &xIndex, &yIndex, boundary.y);
-                            if (xIndex >= 0 && xIndex < boundary.x && yIndex >= 0 && yIndex < boundary.y)
-                                indexVec.push_back(Index(yIndex, xIndex));
-                            break;
-                        }
-                        case 'a':
-                        {
-                            pos.x -= 1.0f;
-                            long xIndex, yIndex;
-                            Util::get_index_from_pos(pos, &xIndex, &yIndex, boundary.y);
-                            if (xIndex >= 0 && xIndex < boundary.x && yIndex >= 0 && yIndex < boundary.y)
-                                indexVec.push_back(Index(yIndex, xIndex));
-                            break;
-                        }
-                        case 's':
-                        {
-                            pos.y -= 1.0f;
-                            long xIndex, yIndex;
-                            Util::get_index_from_pos(pos, &xIndex, &yIndex, boundary.y);
-                            if (xIndex >= 0 && xIndex < boundary.x && yIndex >= 0 && yIndex < boundary.y)
-                                indexVec.push_back(Index(yIndex, xIndex));
-                            break;
-                        }
-                        case 'd':
-                        {
-                            pos.x += 1.0f;
-                            long xIndex, yIndex;
-                            Util::get_index_from_pos(pos, &xIndex, &yIndex, boundary.y);
-                            if (xIndex >= 0 && xIndex < boundary.x && yIndex >= 0 && yIndex < boundary.y)
-                                indexVec.push_back(Index(yIndex, xIndex));
-                            break;
-                        }
-                        }
+                        observation.slots[index] = slot;
+                        *isChanged = true;
                     }
-                    // Now that the pool of indices of next parts are gotten,
-                    // look for the 1 part that doesn't have index within the pool.
-                    bool hasFoundTail = false;
-                    for (auto &entity : snakePartView)
+                    observation.nextWritten.push_back(index);
+                };
+                auto snakePartView = reg.view<SnakePart, Position>();
+                for (auto &entity : snakePartView)
+                    write(snakePartView.get<Position>(entity));
+                auto snakePartHeadView = reg.view<SnakePartHead, Position>();
+                for (auto &entity : snakePartHeadView)
+                    write(snakePartHeadView.get<Position>(entity));
+                auto appleView = reg.view<SnakeApple, Position>();
+                for (auto &entity : appleView)
+                    write(appleView.get<Position>(entity));
+                observation.written.swap(observation.nextWritten);
+            }
+            // Once `written` is full, the slots in it that are empty again or listed twice
+            // make room, so it stays within what reserve() gave it while the snake does.
+            static void note_written(Observation &observation, const long &index)
+            {
+                std::vector<long> &written = observation.written;
+                if (written.size() == written.capacity())
+                {
+                    size_t keptCount = 0U;
+                    for (const long writtenIndex : written)
                     {
-                        const Position pos = reg.get<Position>(entity);
-                        long xIndex, yIndex;
-                        Util::get_index_from_pos(pos, &xIndex, &yIndex, boundary.y);
-                        bool isInPool = false;
-                        for (Index index : indexVec)
-                        {
-                            if (index.i == yIndex && index.j == xIndex)
-                            {
-                                isInPool = true;
-                                break;
-                            }
-                        }
-                        if (!isInPool)
-                        {
-                            hasFoundTail = true;
-                            const Position tailPos = reg.get<Position>(entity);
-                            long xIndex, yIndex;
-                            Util::get_index_from_pos(tailPos, &xIndex, &yIndex, boundary.y);
-                            if (xIndex == j && yIndex == i) // this means it's the tail
-                                return false;
-                            else
-                                return true;
-                        }
+                        Uint8 &slot = observation.slots[writtenIndex];
+                        if (slot == MapSlotState::EMPTY || (slot & SLOT_MARK))
+                            continue;
+                        slot |= SLOT_MARK;
+                        written[keptCount++] = writtenIndex;
                     }
-                    return true;
+                    written.resize(keptCount);
+                    for (const long writtenIndex : written)
+                        observation.slots[writtenIndex] &= ~SLOT_MARK;
                 }
+                written.push_back(index);
             }
-        }
-        return false;
-    }
-    static unsigned long get_score(entt::registry &reg) { return reg.view<SnakePart>().size(); }
-    static bool is_speeding_up(entt::registry &reg) { return reg.get<KeyControl>(reg.view<KeyControl>().front()).isShiftKeyDown; }
 
-    namespace Detail
-    {
-        static bool is_going_backwards(entt::registry &reg, const char &directionToGo)
-        {
-            struct Index
-            {
-                explicit Index(const int &_i, const int &_j) : i(_i), j(_j) {}
-                int i;
-                int j;
-                bool isInvalid() { return i < 0 || j < 0; }
-            };
-            auto map = get_map(reg);
-            Index indexOfSnakeHead(-1, -1);
-            for (int i = 0; i < map.size(); i++)
+            // Slot of the snake head, or false (and -1) if it is out of bounds.
+            static bool get_head_cell(entt::registry &reg, const Grid &board, long *x, long *y)
             {
-                for (int j = 0; j < map[i].size(); j++)
+                *x = *y = -1L;
+                auto snakeHeadView = reg.view<SnakePartHead, Position>();
+                for (auto &entity : snakeHeadView)
                 {
-                    if (map[i][j] == MapSlotState::SNAKE_HEAD)
-                        indexOfSnakeHead = Index(i, j);
+                    long xIndex, yIndex;
+                    board.get_index_from_pos(snakeHeadView.get<Position>(entity), &xIndex, &yIndex);
+                    if (board.is_in_bounds(xIndex, yIndex))
+                    {
+                        *x = xIndex;
+                        *y = yIndex;
+                        return true;
+                    }
                 }
+                return false;
             }
-            if (indexOfSnakeHead.isInvalid())
-                return true;
 
-            int i = indexOfSnakeHead.i, j = indexOfSnakeHead.j;
-            switch (directionToGo)
-            { // check if it's a wall or not a snake body
-            case 'w':
-                if (i == 0)
-                    return false;
-                if (map[i - 1][j] != MapSlotState::SNAKE_BODY)
-                    return false;
-                break;
-            case 'a':
-                if (j == 0)
-                    return false;
-                if (map[i][j - 1] != MapSlotState::SNAKE_BODY)
-                    return false;
-                break;
-            case 's':
-                if (i == map.size() - 1)
-                    return false;
-                if (map[i + 1][j] != MapSlotState::SNAKE_BODY)
-                    return false;
-                break;
-            case 'd':
-                if (j == map[i].size() - 1)
-                    return false;
-                if (map[i][j + 1] != MapSlotState::SNAKE_BODY)
-                    return false;
-                break;
-            default:
-                return true;
+            static bool is_game_success(const Grid &board) { return board.get_occupied_count() == board.area(); }
+            static GameStatus get_status(entt::registry &reg, Grid &board)
+            {
+                if (is_game_success(board))
+                    return GameStatus::WON;
+                return is_game_failure(reg, board) ? GameStatus::LOST : GameStatus::PLAYING;
             }
+            static bool is_game_failure(entt::registry &reg, Grid &board)
+            {
+                auto snakeHeadPos = reg.get<Position>(reg.view<SnakePartHead, Position>().front());
+                if (snakeHeadPos.x < 0.0f || snakeHeadPos.x >= board.width() || snakeHeadPos.y < 0.0f || snakeHeadPos.y >= board.height())
+                    return true;
 
-            // It's a snake body at the directionToGo. Find out if it's
-            // the "neck". If it's not, return false.
-            auto snakeBoundaryView = reg.view<SnakeBoundary2D>();
-            SDL_assert(snakeBoundaryView.size() == 1);
-            const SnakeBoundary2D boundary = reg.get<SnakeBoundary2D>(snakeBoundaryView.front());
+                long x, y;
+                board.get_index_from_pos(snakeHeadPos, &x, &y);
+                const MapSlotState slot = board.get(board.to_index(x, y));
+                if (!((slot & MapSlotState::SNAKE_HEAD) && (slot & MapSlotState::SNAKE_BODY)))
+                    return false;
 
-            auto view = reg.view<Position, SnakePart>();
-            for (auto &entity : view)
-            {
-                const Position &pos = reg.get<Position>(entity);
+                // Running into the tail is fine, since it moves out of the way this step.
+                entt::entity tail;
+                if (!find_tail(reg, board, &tail))
+                    return true;
                 long xIndex, yIndex;
-                Util::get_index_from_pos(pos, &xIndex, &yIndex, boundary.y);
-                switch (directionToGo)
-                {
-                // Get the body part in that direction and get its currentDirection.
-                // If the currentDirection is opposite of directionToGo, return true.
-                case 'w':
-                {
-                    if (xIndex == j && yIndex == i - 1 && reg.get<SnakePart>(entity).currentDirection == 's')
-                        return true;
-                    break;
-                }
-                case 'a':
+                board.get_index_from_pos(reg.get<Position>(tail), &xIndex, &yIndex);
+                return !(xIndex == x && yIndex == y);
+            }
+
+            // Every part points at the next one, so the tail is the one part no other part
+            // points at. Mark the slots being pointed at, then look for an unmarked part.
+            // A neck about to be added in neckIndex (if not -1) takes part too: it points at
+            // neckPointedIndex (if not -1) and comes first, as the newest part does in a view.
+            // If it would be the tail, *tail is entt::null.
+            static bool find_tail(entt::registry &reg, Grid &board, entt::entity *tail, const long &neckIndex = -1L, const long &neckPointedIndex = -1L)
+            {
+                auto snakePartView = reg.view<Position, SnakePart>();
+                auto forEachPointedSlot = [&board, &snakePartView](auto &&func)
                 {
-                    if (xIndex == j - 1 && yIndex == i && reg.get<SnakePart>(entity).currentDirection == 'd')
-                        return true;
-                    break;
-                }
-                case 's':
+                    for (const auto &entity : snakePartView)
+                    {
+                        Position pos = snakePartView.get<Position>(entity);
+                        const Direction direction = to_direction(snakePartView.get<SnakePart>(entity).currentDirection);
+                        if (direction == Direction::NO_DIRECTION)
+                            continue;
+                        pos.x += DIRECTION_POS_DX[direction];
+                        pos.y += DIRECTION_POS_DY[direction];
+                        long xIndex, yIndex;
+                        board.get_index_from_pos(pos, &xIndex, &yIndex);
+                        if (board.is_in_bounds(xIndex, yIndex))
+                            func(board.to_index(xIndex, yIndex));
+                    }
+                };
+
+                forEachPointedSlot([&board](const long &index)
+                                   { board.mark(index); });
+                if (neckPointedIndex >= 0L)
+                    board.mark(neckPointedIndex);
+                bool hasFoundTail = false;
+                if (neckIndex >= 0L && !board.is_marked(neckIndex))
                 {
-                    if (xIndex == j && yIndex == i + 1 && reg.get<SnakePart>(entity).currentDirection == 'w')
-                        return true;
-                    break;
+                    hasFoundTail = true;
+                    *tail = entt::null;
                 }
-                case 'd':
+                for (const auto &entity : snakePartView)
                 {
-                    if (xIndex == j + 1 && yIndex == i && reg.get<SnakePart>(entity).currentDirection == 'a')
-                        return true;
-                    break;
-                }
-                default:
-                    SDL_assert(directionToGo == 'w' || directionToGo == 'a' || directionToGo == 's' || directionToGo == 'd');
-                    return true;
+                    if (hasFoundTail)
+                        break;
+                    long xIndex, yIndex;
+                    board.get_index_from_pos(snakePartView.get<Position>(entity), &xIndex, &yIndex);
+                    if (!board.is_in_bounds(xIndex, yIndex) || !board.is_marked(board.to_index(xIndex, yIndex)))
+                    {
+                        hasFoundTail = true;
+                        *tail = entity;
+                        break;
+                    }
                 }
+                forEachPointedSlot([&board](const long &index)
+                                   { board.unmark(index); });
+                if (neckPointedIndex >= 0L)
+                    board.unmark(neckPointedIndex);
+                return hasFoundTail;
             }
-            return false;
-        }
-        static void do_trailing(entt::registry &reg, const bool &isAteApple)
-        { // NOTE: this function is the reason why the update loop NEEDS to limit DeltaTime
-            auto currentMap = get_map(reg);
-            if (currentMap == previousMap)
-                return;
 
-            struct Index
+            // A neck grown this tick is not in the registry yet: it is in grownNeckIndex (if not -1),
+            // pointing in grownNeckDirection.
+            static bool is_going_backwards(entt::registry &reg, const Grid &board, const Direction &directionToGo,
+                                           const long &grownNeckIndex = -1L, const Direction &grownNeckDirection = Direction::NO_DIRECTION)
             {
-                explicit Index(const int &_i, const int &_j) : i(_i), j(_j) {}
-                int i;
-                int j;
-            }; // struct Index
+                long x, y;
+                if (!get_head_cell(reg, board, &x, &y) || board.get(board.to_index(x, y)) != MapSlotState::SNAKE_HEAD)
+                    return true;
 
-            auto getSnakeHeadIndices = [](const std::vector<std::vector<MapSlotState>> &map)
-            {
-                Index ret(-1, -1);
-                for (int i = 0; i < map.size(); i++)
+                long neckIndex;
+                if (directionToGo == Direction::NO_DIRECTION)
+                    return true;
+                if (!board.step(board.to_index(x, y), directionToGo, &neckIndex))
+                    return false; // it's a wall
+                if (board.get(neckIndex) != MapSlotState::SNAKE_BODY)
+                    return false;
+
+                // It's a snake body at the directionToGo. Find out if it's
+                // the "neck", i.e. it points back at the head.
+                const Direction opposite = OPPOSITE_DIRECTION[directionToGo];
+                if (neckIndex == grownNeckIndex && grownNeckDirection == opposite)
+                    return true;
+                auto view = reg.view<Position, SnakePart>();
+                for (auto &entity : view)
                 {
-                    for (int j = 0; j < map[i].size(); j++)
-                    {
-                        if (map[i][j] & MapSlotState::SNAKE_HEAD)
-                            return Index(i, j);
-                    }
+                    long xIndex, yIndex;
+                    board.get_index_from_pos(view.get<Position>(entity), &xIndex, &yIndex);
+                    if (board.is_in_bounds(xIndex, yIndex) && board.to_index(xIndex, yIndex) == neckIndex && to_direction(view.get<SnakePart>(entity).currentDirection) == opposite)
+                        return true;
                 }
-                return ret;
-            };
-
-            Index previousSnakeHeadIndex = getSnakeHeadIndices(previousMap);
-            Index currentSnakeHeadIndex = getSnakeHeadIndices(currentMap);
-
-            if (previousSnakeHeadIndex.i == currentSnakeHeadIndex.i && previousSnakeHeadIndex.j == currentSnakeHeadIndex.j)
-                return;
+                return false;
+            }
 
-            char travelledDirection = '\t';
-            if (currentSnakeHeadIndex.i < previousSnakeHeadIndex.i)
-                travelledDirection = 'w';
-            else if (currentSnakeHeadIndex.j < previousSnakeHeadIndex.j)
-                travelledDirection = 'a';
-            else if (currentSnakeHeadIndex.i > previousSnakeHeadIndex.i)
-                travelledDirection = 's';
-            else if (currentSnakeHeadIndex.j > previousSnakeHeadIndex.j)
-                travelledDirection = 'd';
+            static Trail plan_trailing(entt::registry &reg, const State &state)
+            {
+                Trail ret = {false, Direction::NO_DIRECTION, -1L, -1L};
+                long x, y;
+                get_head_cell(reg, state.board, &x, &y);
+                if (x == state.previousHeadX && y == state.previousHeadY)
+                    return ret;
+
+                ret.direction = get_travelled_direction(state.previousHeadX, state.previousHeadY, x, y);
+                SDL_assert(ret.direction != Direction::NO_DIRECTION);
+                ret.isMoving = true;
+                ret.spawnX = x - DIRECTION_DX[ret.direction];
+                ret.spawnY = y - DIRECTION_DY[ret.direction];
+                return ret;
+            }
+            // Room for the longest snake the board holds. reg.clear() keeps the storages' capacity
+            // and the state stays in reg.ctx(), so a restart on the same registry, and the growth
+            // after it, reuse what the first game reserved instead of allocating.
+            static void reserve(entt::registry &reg, State &state)
+            {
+                const size_t partCount = static_cast<size_t>(std::min(state.board.area(), MAX_RESERVED_PARTS));
+                reg.storage<SnakePart>().reserve(partCount);
+                reg.storage<Position>().reserve(partCount + 2U); // the head and the apple too
+                state.spareParts.reserve(partCount);
+                state.placements.reserve(partCount + 2U + static_cast<size_t>(SPARE_PART_BATCH));
+                state.observation.written.reserve(partCount + 2U);
+                state.observation.nextWritten.reserve(partCount + 2U);
+                Resource::get<ChangeTracker>(reg).reserve(partCount + 2U);
+            }
 
-            SDL_assert(travelledDirection != '\t');
-            if (travelledDirection == '\t')
-                return;
+            // Drops spare entities a reg.clear() took away and tops the rest up to a batch.
+            // Only init() calls it: during a tick, entities are only made by the CommandBuffer.
+            static void fill_spare_parts(entt::registry &reg, State &state)
+            {
+                std::vector<entt::entity> &spareParts = state.spareParts;
+                spareParts.erase(std::remove_if(spareParts.begin(), spareParts.end(), [&reg](const entt::entity &entity)
+                                                { return !reg.valid(entity); }),
+                                 spareParts.end());
+                while (static_cast<long>(spareParts.size()) < SPARE_PART_BATCH)
+                    spareParts.push_back(reg.create());
+            }
+            // entt::null once they run out.
+            static entt::entity take_spare_part(entt::registry &reg, State &state)
+            {
+                while (!state.spareParts.empty() && !reg.valid(state.spareParts.back()))
+                    state.spareParts.pop_back();
+                if (state.spareParts.empty())
+                    return entt::null;
+                const entt::entity entity = state.spareParts.back();
+                state.spareParts.pop_back();
+                return entity;
+            }
 
-            auto snakePartView = reg.view<SnakePart>();
-            if (snakePartView.empty())
+            // NOTE: this function is the reason why the update loop NEEDS to limit DeltaTime
+            // The board is brought to what it is once the CommandBuffer is applied.
+            static void do_trailing(entt::registry &reg, State &state, const Trail &trail, const bool &isAteApple)
             {
-                if (!isAteApple)
+                if (!trail.isMoving)
                     return;
 
-                // Ate apple, so spawn a part behind the snake head.
-                auto snakeBoundaryView = reg.view<SnakeBoundary2D>();
-                SDL_assert(snakeBoundaryView.size() == 1);
-                const SnakeBoundary2D boundary = reg.get<SnakeBoundary2D>(snakeBoundaryView.front());
-                const int i = currentSnakeHeadIndex.i, j = currentSnakeHeadIndex.j;
-                switch (travelledDirection)
-                {
-                case 'w':
-                {
-                    auto entitySnakePart = reg.create();
-                    reg.emplace<SnakePart>(entitySnakePart, 'w');
-                    reg.emplace<Position>(entitySnakePart, Util::get_pos_from_index(j, i + 1, boundary.y));
-                    break;
-                }
-                case 'a':
-                {
-                    auto entitySnakePart = reg.create();
-                    reg.emplace<SnakePart>(entitySnakePart, 'a');
-                    reg.emplace<Position>(entitySnakePart, Util::get_pos_from_index(j + 1, i, boundary.y));
-                    break;
-                }
-                case 's':
-                {
-                    auto entitySnakePart = reg.create();
-                    reg.emplace<SnakePart>(entitySnakePart, 's');
-                    reg.emplace<Position>(entitySnakePart, Util::get_pos_from_index(j, i - 1, boundary.y));
-                    break;
-                }
-                case 'd':
-                {
-                    auto entitySnakePart = reg.create();
-                    reg.emplace<SnakePart>(entitySnakePart, 'd');
-                    reg.emplace<Position>(entitySnakePart, Util::get_pos_from_index(j - 1, i, boundary.y));
-                    break;
-                }
-                } // switch (travelledDirection)
-            }
-            else
-            {
-                auto snakeBoundaryView = reg.view<SnakeBoundary2D>();
-                SDL_assert(snakeBoundaryView.size() == 1);
-                const SnakeBoundary2D boundary = reg.get<SnakeBoundary2D>(snakeBoundaryView.front());
-                int i = currentSnakeHeadIndex.i, j = currentSnakeHeadIndex.j;
-                switch (travelledDirection)
-                { // spawn in neck part
-                case 'w':
-                {
-                    auto entitySnakePart = reg.create();
-                    reg.emplace<SnakePart>(entitySnakePart, 'w');
-                    reg.emplace<Position>(entitySnakePart, Util::get_pos_from_index(j, ++i, boundary.y));
-                    break;
-                }
-                case 'a':
-                {
-                    auto entitySnakePart = reg.create();
-                    reg.emplace<SnakePart>(entitySnakePart, 'a');
-                    reg.emplace<Position>(entitySnakePart, Util::get_pos_from_index(++j, i, boundary.y));
-                    break;
-                }
-                case 's':
-                {
-                    auto entitySnakePart = reg.create();
-                    reg.emplace<SnakePart>(entitySnakePart, 's');
-                    reg.emplace<Position>(entitySnakePart, Util::get_pos_from_index(j, --i, boundary.y));
-                    break;
-                }
-                case 'd':
-                {
-                    auto entitySnakePart = reg.create();
-                    reg.emplace<SnakePart>(entitySnakePart, 'd');
-                    reg.emplace<Position>(entitySnakePart, Util::get_pos_from_index(--j, i, boundary.y));
-                    break;
-                }
-                } // switch (travelledDirection)
+                const bool hasSnakePart = !reg.view<SnakePart>().empty();
+                if (!hasSnakePart && !isAteApple)
+                    return;
 
-                if (!isAteApple)
+                // Since no apple is eaten, the tail becomes the new neck: only its Position and
+                // SnakePart change, no entity comes or goes. The tail is looked for as if the
+                // neck was there already, pointing at the head's slot, so a tail the head is
+                // chasing into it stays; iterate() removes it then.
+                Grid &board = state.board;
+                const Position neckPos = board.get_pos_from_index(trail.spawnX, trail.spawnY);
+                if (hasSnakePart && !isAteApple)
                 {
-                    // At this point, i and j are at the neck (already spawned in).
-                    // Since no apple is eaten, we need to destroy the tail.
-                    // We can find the tail by looking at all the SnakePart
-                    // currentDirection as well as their Position to determine
-                    // where the next part should be. Have a pool of these next part
-                    // indices. The tail is the one that has a pos not in that pool.
-                    auto snakePartView = reg.view<Position, SnakePart>();
-                    std::vector<Index> indexVec;
-                    for (const auto &entity : snakePartView)
+                    if (!board.is_in_bounds(trail.spawnX, trail.spawnY))
+                        return; // a neck there would be the tail, and go straight away again
+                    const long headX = trail.spawnX + DIRECTION_DX[trail.direction];
+                    const long headY = trail.spawnY + DIRECTION_DY[trail.direction];
+                    const bool isPointing = trail.direction != Direction::NO_DIRECTION && board.is_in_bounds(headX, headY);
+                    entt::entity tail;
+                    if (find_tail(reg, board, &tail, board.to_index(trail.spawnX, trail.spawnY), isPointing ? board.to_index(headX, headY) : -1L))
                     {
-                        const bool isValid = reg.all_of<SnakePart, Position>(entity);
-                        SDL_assert(isValid);
-                        Position pos = reg.get<Position>(entity);
-                        const SnakePart snakePart = reg.get<SnakePart>(entity);
-                        switch (snakePart.currentDirection)
-                        {
-                        case 'w':
-                        {
-                            pos.y += 1.0f;
-                            long xIndex, yIndex;
-                            Util::get_index_from_pos(pos, &xIndex, &yIndex, boundary.y);
-                            if (xIndex >= 0 && xIndex < boundary.x && yIndex >= 0 && yIndex < boundary.y)
-                                indexVec.push_back(Index(yIndex, xIndex));
-                            break;
-                        }
-                        case 'a':
-                        {
-                            pos.x -= 1.0f;
-                            long xIndex, yIndex;
-                            Util::get_index_from_pos(pos, &xIndex, &yIndex, boundary.y);
-                            if (xIndex >= 0 && xIndex < boundary.x && yIndex >= 0 && yIndex < boundary.y)
-                                indexVec.push_back(Index(yIndex, xIndex));
-                            break;
-                        }
-                        case 's':
-                        {
-                            pos.y -= 1.0f;
-                            long xIndex, yIndex;
-                            Util::get_index_from_pos(pos, &xIndex, &yIndex, boundary.y);
-                            if (xIndex >= 0 && xIndex < boundary.x && yIndex >= 0 && yIndex < boundary.y)
-                                indexVec.push_back(Index(yIndex, xIndex));
-                            break;
-                        }
-                        case 'd':
-                        {
-                            pos.x += 1.0f;
-                            long xIndex, yIndex;
-                            Util::get_index_from_pos(pos, &xIndex, &yIndex, boundary.y);
-                            if (xIndex >= 0 && xIndex < boundary.x && yIndex >= 0 && yIndex < boundary.y)
-                                indexVec.push_back(Index(yIndex, xIndex));
-                            break;
-                        }
-                        }
+                        if (tail == entt::null)
+                            return; // likewise
+                        reg.patch<SnakePart>(tail, [&trail](SnakePart &part)
+                                             { part.currentDirection = DIRECTION_KEY[trail.direction]; });
+                        reg.replace<Position>(tail, neckPos);
+                        place(reg, state, tail);
+                        return;
                     }
-                    // Now that the pool of indices of next parts are gotten,
-                    // look for the 1 part that doesn't have index within the pool.
-                    bool hasFoundTail = false;
-                    for (auto &entity : snakePartView)
-                    {
-                        const Position pos = reg.get<Position>(entity);
-                        long xIndex, yIndex;
-                        Util::get_index_from_pos(pos, &xIndex, &yIndex, boundary.y);
-                        bool isInPool = false;
-                        for (Index index : indexVec)
-                        {
-                            if (index.i == yIndex && index.j == xIndex)
-                            {
-                                isInPool = true;
-                                break;
-                            }
-                        }
-                        if (!isInPool)
-                        {
-                            hasFoundTail = true;
-                            reg.destroy(entity);
-                            break;
-                        }
-                    }
-                    SDL_assert(hasFoundTail);
                 }
-            }
-        }
-        static bool apple_update(entt::registry &reg)
-        {
-            auto map = get_map(reg);
-            struct Index
-            {
-                explicit Index(const int &_i, const int &_j) : i(_i), j(_j) {}
-                int i;
-                int j;
-            };
-            std::vector<Index> indexVec;
-            bool isEaten = false;
-            for (int i = 0; i < map.size(); i++)
-            {
-                for (int j = 0; j < map[i].size(); j++)
+
+                // Grow a neck part, or a part behind the head if it is the first one.
+                CommandBuffer &commandBuffer = Resource::get_or_emplace<CommandBuffer>(reg);
+                auto grow = [&commandBuffer, &trail, &neckPos](const auto &entitySnakePart)
                 {
-                    if (map[i][j] == MapSlotState::EMPTY)
-                        indexVec.push_back(Index(i, j));
-                    else if ((map[i][j] & MapSlotState::SNAKE_HEAD) && (map[i][j] & MapSlotState::APPLE))
-                    {
-                        isEaten = true;
-                    }
+                    commandBuffer.emplace<SnakePart>(entitySnakePart, DIRECTION_KEY[trail.direction]);
+                    commandBuffer.emplace<Position>(entitySnakePart, neckPos);
+                };
+                const entt::entity entitySnakePart = take_spare_part(reg, state);
+                if (entitySnakePart == entt::null)
+                    grow(commandBuffer.create());
+                else
+                    grow(entitySnakePart);
+                if (board.is_in_bounds(trail.spawnX, trail.spawnY))
+                {
+                    state.grownNeckIndex = board.to_index(trail.spawnX, trail.spawnY);
+                    state.grownNeckDirection = trail.direction;
+                    // A part the CommandBuffer creates is put on the board when it shows up as changed.
+                    if (entitySnakePart == entt::null)
+                        board.add(state.grownNeckIndex, MapSlotState::SNAKE_BODY);
+                    else
+                        put(state, entitySnakePart, state.grownNeckIndex, MapSlotState::SNAKE_BODY);
                 }
             }
-            Detail::do_trailing(reg, isEaten);
 
-            auto respawnApple = [](entt::registry &reg, const std::vector<Index> &indexVec)
+            // n-th empty slot in row-major order, not counting skipIndex.
+            static long get_nth_empty_slot(const Grid &board, const long &n, const long &skipIndex)
+            {
+                const long index = board.get_nth_empty(n);
+                if (skipIndex >= 0L && index >= skipIndex && board.get(skipIndex) == MapSlotState::EMPTY)
+                    return board.get_nth_empty(n + 1L);
+                return index;
+            }
+            // Leaves the board as it is once the CommandBuffer is applied, without looking at the registry again.
+            static bool apple_update(entt::registry &reg, State &state)
             {
+                Grid &board = state.board;
+                state.grownNeckIndex = -1L;
+                long x, y;
+                const bool isEaten = get_head_cell(reg, board, &x, &y) && (board.get(board.to_index(x, y)) & MapSlotState::APPLE);
+                const Trail trail = plan_trailing(reg, state);
+
+                // The new apple goes to one of the slots that are empty before trailing. The slot
+                // the head just left is among them, so if the new neck lands on the pick, pick
+                // again from the remaining ones.
                 auto appleView = reg.view<SnakeApple, Position>();
                 SDL_assert(appleView.storage<SnakeApple>()->size() <= 1);
-                const bool isNoApple = appleView.storage<SnakeApple>()->empty();
-                if (!isNoApple) // don't spawn in when there's no apple
+                const bool isRespawning = isEaten && !appleView.storage<SnakeApple>()->empty();
+                long appleIndex = -1L; // stays -1 if there is nowhere to respawn
+                if (isRespawning && board.get_empty_count() > 0L)
                 {
-                    if (indexVec.empty())
-                        reg.destroy(appleView.front());
-                    else
+                    appleIndex = get_nth_empty_slot(board, get_random(reg, board.get_empty_count()), -1L);
+                    if (trail.isMoving && board.is_in_bounds(trail.spawnX, trail.spawnY) && appleIndex == board.to_index(trail.spawnX, trail.spawnY))
                     {
-                        Position &applePos = reg.get<Position>(appleView.front());
-                        const Sint32 indexVexIndex = SDL_rand(indexVec.size());
-                        const int y = indexVec[indexVexIndex].i;
-                        const int x = indexVec[indexVexIndex].j;
-
-                        auto snakeBoundaryView = reg.view<SnakeBoundary2D>();
-                        SDL_assert(snakeBoundaryView.size() == 1);
-                        const SnakeBoundary2D boundary = reg.get<SnakeBoundary2D>(snakeBoundaryView.front());
-                        applePos = Util::get_pos_from_index(x, y, boundary.y);
+                        if (board.get_empty_count() > 1L)
+                            appleIndex = get_nth_empty_slot(board, get_random(reg, board.get_empty_count() - 1L), appleIndex);
+                        else
+                            appleIndex = -1L;
                     }
                 }
-            };
 
-            if (isEaten)
-            {
-                respawnApple(reg, indexVec);
-                map = get_map(reg);
+                do_trailing(reg, state, trail, isEaten);
 
-                bool hasErased = false;
-                for (auto it = indexVec.begin(); it != indexVec.end();) // search for conflicting spots since the head was detached
-                {                                                       // solves apple at neck issue
-                    Index index = *it;
-                    if ((map[index.i][index.j] & MapSlotState::APPLE) && map[index.i][index.j] > MapSlotState::APPLE)
+                if (isRespawning)
+                {
+                    const entt::entity appleEntity = reg.view<SnakeApple, Position>().front();
+                    if (appleIndex < 0L)
                     {
-                        hasErased = true;
-                        it = indexVec.erase(it); // erase() returns iterator to next element
+                        Resource::get_or_emplace<CommandBuffer>(reg).destroy(appleEntity);
+                        lift(state, appleEntity);
                     }
                     else
-                        ++it;
+                    {
+                        long appleX, appleY;
+                        board.from_index(appleIndex, &appleX, &appleY);
+                        reg.replace<Position>(appleEntity, board.get_pos_from_index(appleX, appleY));
+                        place(reg, state, appleEntity);
+                    }
                 }
-                if (hasErased)
-                    respawnApple(reg, indexVec);
+
+                // What the CommandBuffer does later is news to the board, but nothing before it is.
+                state.boardCursor = Resource::get<ChangeTracker>(reg).get_cursor();
+                return isEaten;
             }
+        }; // struct Engine
+    } // namespace Detail
+
+    using Access = Detail::Engine<ChunkedGrid>::Access;
+    static void iterate(entt::registry &reg) { Detail::Engine<ChunkedGrid>::iterate(reg); }
+    static void update(entt::registry &reg) { Detail::Engine<ChunkedGrid>::update(reg); }
 
-            return isEaten;
+    static bool init(entt::registry &reg) { return Detail::Engine<ChunkedGrid>::init(reg); }
+    static bool init(sigslot::signal<entt::registry &> &signal, entt::registry &reg)
+    {
+        static std::list<sigslot::signal<entt::registry &> *> regSignalArray;
+        bool ret = true;
+        for (auto connectedSignal : regSignalArray)
+        {
+            if (connectedSignal == &signal)
+            {
+                ret = false;
+                break;
+            }
         }
-    } // namespace Detail
+        if (ret)
+        {
+            signal.connect(SnakeGameplaySystem::update);
+            regSignalArray.push_back(&signal);
+            init(reg);
+        }
+        return ret;
+    }
+
+    static const ChunkedGrid &get_board(entt::registry &reg) { return Detail::Engine<ChunkedGrid>::get_board(reg); }
+    static BoardView get_board_view(entt::registry &reg) { return Detail::Engine<ChunkedGrid>::get_board_view(reg); }
+    static std::vector<std::vector<MapSlotState>> get_map(entt::registry &reg)
+    {
+        const ChunkedGrid &board = get_board(reg);
+        std::vector<std::vector<MapSlotState>> ret(board.height(), std::vector<MapSlotState>(board.width(), MapSlotState::EMPTY));
+        for (long i = 0; i < board.height(); i++)
+        {
+            for (long j = 0; j < board.width(); j++)
+                ret[i][j] = board.get(board.to_index(j, i));
+        }
+        return ret;
+    }
+    static bool is_game_success(entt::registry &reg) { return Detail::Engine<ChunkedGrid>::is_game_success(reg); }
+    static bool is_game_failure(entt::registry &reg) { return Detail::Engine<ChunkedGrid>::is_game_failure(reg); }
+    static GameStatus get_status(entt::registry &reg) { return Detail::Engine<ChunkedGrid>::get_status(reg); }
+    static unsigned long get_score(entt::registry &reg) { return reg.view<SnakePart>().size(); }
+    static bool is_speeding_up(entt::registry &reg) { return Resource::get<KeyControl>(reg).isShiftKeyDown; }
+
+    static entt::entity spawn_scene(entt::registry &reg, const int &width, const int &height, const Uint64 &seed,
+                                    const Uint64 &tickPeriodMs, const float &speed, const float &speedUpFactor)
+    {
+        SDL_assert(width >= MIN_SCENE_WIDTH && height >= 1);
+        reg.clear();
+        Resource::set<DeltaTime>(reg, tickPeriodMs);
+        Resource::set<KeyControl>(reg, 'd', false);
+        Resource::set<SnakeBoundary2D>(reg, width, height);
+        Resource::set<RandomState>(reg, seed);
+
+        auto appleEntity = reg.create();
+        const float centerX = static_cast<float>(width) / 2.0f;
+        const float centerY = static_cast<float>(height) / 2.0f;
+        reg.emplace<Position>(appleEntity, centerX, centerY);
+        reg.emplace<SnakeApple>(appleEntity);
+
+        auto snakeHeadEntity = reg.create();
+        reg.emplace<Position>(snakeHeadEntity, 2.5f, centerY >= 1.5f ? centerY - 1.0f : 0.5f);
+        reg.emplace<Velocity>(snakeHeadEntity, 0.0f, 0.0f);
+        reg.emplace<SnakePartHead>(snakeHeadEntity, speed, speedUpFactor);
+        return snakeHeadEntity;
+    }
 
     namespace Control
     {
         static void shift_key_up(entt::registry &reg)
         {
-            auto keyControlView = reg.view<KeyControl>();
-            SDL_assert(keyControlView.size() == 1);
-            keyControlView.each([](KeyControl &control)
-                                { control.isShiftKeyDown = false; });
+            Resource::get<KeyControl>(reg).isShiftKeyDown = false;
         }
         static void shift_key_down(entt::registry &reg)
         {
-            auto keyControlView = reg.view<KeyControl>();
-            SDL_assert(keyControlView.size() == 1);
-            keyControlView.each([](KeyControl &control)
-                                { control.isShiftKeyDown = true; });
+            Resource::get<KeyControl>(reg).isShiftKeyDown = true;
         }
         static void up_key_down(entt::registry &reg)
         {
-            auto keyControlView = reg.view<KeyControl>();
-            SDL_assert(keyControlView.size() == 1);
-            keyControlView.each([](KeyControl &control)
-                                { control.lastMovementKeyDown = 'w'; });
+            Resource::get<KeyControl>(reg).lastMovementKeyDown = 'w';
         }
         static void left_key_down(entt::registry &reg)
         {
-            auto keyControlView = reg.view<KeyControl>();
-            SDL_assert(keyControlView.size() == 1);
-            keyControlView.each([](KeyControl &control)
-                                { control.lastMovementKeyDown = 'a'; });
+            Resource::get<KeyControl>(reg).lastMovementKeyDown = 'a';
         }
         static void down_key_down(entt::registry &reg)
         {
-            auto keyControlView = reg.view<KeyControl>();
-            SDL_assert(keyControlView.size() == 1);
-            keyControlView.each([](KeyControl &control)
-                                { control.lastMovementKeyDown = 's'; });
+            Resource::get<KeyControl>(reg).lastMovementKeyDown = 's';
         }
         static void right_key_down(entt::registry &reg)
         {
-            auto keyControlView = reg.view<KeyControl>();
-            SDL_assert(keyControlView.size() == 1);
-            keyControlView.each([](KeyControl &control)
-                                { control.lastMovementKeyDown = 'd'; });
+            Resource::get<KeyControl>(reg).lastMovementKeyDown = 'd';
         }
     } // namespace Control
 
@@ -0,0 +1,534 @@
+#ifndef SRC_SYSTEM_SNAKE_GRID_HPP
+#define SRC_SYSTEM_SNAKE_GRID_HPP
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <SDL3/SDL_assert.h>
+#include <SDL3/SDL_stdinc.h>
+
+#include <component/position.hpp>
+#include <system/snake_direction.hpp>
+
+namespace SnakeGameplaySystem
+{
+    enum MapSlotState : Uint8
+    {
+        EMPTY = 0b0000U,
+        SNAKE_HEAD = 0b0001U,
+        SNAKE_BODY = 0b0010U,
+        APPLE = 0b0100U,
+
+        ENUM_END = 0b1111U,
+    }; // enum MapSlotState
+
+    namespace Detail
+    {
+        // Scratch bit used while looking for the tail. It is never left set between calls.
+        static constexpr Uint8 SLOT_MARK = 0b1000U;
+        static constexpr Uint8 SLOT_OCCUPIED = MapSlotState::SNAKE_HEAD | MapSlotState::SNAKE_BODY;
+
+        static constexpr long floor_to_long(const float &value)
+        {
+            const long truncated = static_cast<long>(value);
+            return (static_cast<float>(truncated) > value) ? truncated - 1L : truncated;
+        }
+
+        // Same results as Util::get_index_from_pos(), but usable in constant expressions.
+        static constexpr long get_column_from_pos(const float &x) { return floor_to_long(x); }
+        static constexpr long get_row_from_pos(const float &y, const long &sizeY)
+        {
+            if (sizeY == 1) // same as Util::get_index_from_pos()
+                return 0L;
+            return sizeY - 1L - floor_to_long(y);
+        }
+        static constexpr Position get_pos_from_cell(const long &x, const long &y, const long &sizeY)
+        {
+            return Position{static_cast<float>(x + 1L) - 0.5f, static_cast<float>(sizeY - y) - 0.5f};
+        }
+    } // namespace Detail
+
+    // Read-only look at a board as one MapSlotState byte per slot, row after row.
+    // Slot (x, y) is data[y * stride + x]. generation changes whenever the contents do.
+    struct BoardView
+    {
+        const Uint8 *data;
+        long width;
+        long height;
+        long stride;
+        Uint64 generation;
+    }; // struct BoardView
+
+    // Board with the size of the SnakeBoundary2D read at run time.
+    class DynamicGrid
+    {
+    public:
+        void reset(const long &width, const long &height)
+        {
+            SDL_assert(width >= 0L && height >= 0L);
+            widthCells = width;
+            heightCells = height;
+            cells.assign(static_cast<size_t>(width * height), MapSlotState::EMPTY); // keeps capacity
+            for (const Direction direction : Detail::DIRECTIONS)
+                indexOffsets[direction] = Detail::get_index_offset(direction, width);
+            emptyCount = width * height;
+            occupiedCount = 0L;
+        }
+
+        long width() const { return widthCells; }
+        long height() const { return heightCells; }
+        long area() const { return widthCells * heightCells; }
+
+        bool is_in_bounds(const long &x, const long &y) const { return x >= 0L && y >= 0L && x < widthCells && y < heightCells; }
+        long to_index(const long &x, const long &y) const { return y * widthCells + x; }
+        void from_index(const long &index, long *x, long *y) const
+        {
+            *x = index % widthCells;
+            *y = index / widthCells;
+        }
+        void get_index_from_pos(const Position &pos, long *x, long *y) const
+        {
+            *x = Detail::get_column_from_pos(pos.x);
+            *y = Detail::get_row_from_pos(pos.y, heightCells);
+        }
+        Position get_pos_from_index(const long &x, const long &y) const { return Detail::get_pos_from_cell(x, y, heightCells); }
+
+        bool step(const long &index, const Direction &direction, long *next) const
+        {
+            long x, y;
+            from_index(index, &x, &y);
+            *next = index + indexOffsets[direction];
+            return direction != Direction::NO_DIRECTION && is_in_bounds(x + Detail::DIRECTION_DX[direction], y + Detail::DIRECTION_DY[direction]);
+        }
+        template <typename Func>
+        void for_each_neighbour(const long &index, Func &&func) const
+        {
+            for (const Direction direction : Detail::DIRECTIONS)
+            {
+                long next;
+                if (step(index, direction, &next))
+                    func(direction, next);
+            }
+        }
+
+        MapSlotState get(const long &index) const { return static_cast<MapSlotState>(cells[index] & ~Detail::SLOT_MARK); }
+        void add(const long &index, const Uint8 &bits) { write(index, cells[index] | bits); }
+        void remove(const long &index, const Uint8 &bits) { write(index, cells[index] & ~bits); }
+
+        void mark(const long &index) { cells[index] |= Detail::SLOT_MARK; }
+        void unmark(const long &index) { cells[index] &= ~Detail::SLOT_MARK; }
+        bool is_marked(const long &index) const { return cells[index] & Detail::SLOT_MARK; }
+
+        long get_empty_count() const { return emptyCount; }
+        long get_occupied_count() const { return occupiedCount; } // slots with a snake head or body
+        long get_nth_empty(long n) const // in row-major order, -1 if there are not that many
+        {
+            for (long index = 0L; index < area(); index++)
+            {
+                if (get(index) == MapSlotState::EMPTY && n-- == 0L)
+                    return index;
+            }
+            return -1L;
+        }
+
+        bool operator==(const DynamicGrid &other) const { return widthCells == other.widthCells && cells == other.cells; }
+        bool operator!=(const DynamicGrid &other) const { return !(*this == other); }
+
+    private:
+        void write(const long &index, const Uint8 &value)
+        {
+            const Uint8 before = cells[index] & ~Detail::SLOT_MARK;
+            const Uint8 after = value & ~Detail::SLOT_MARK;
+            emptyCount += (after == MapSlotState::EMPTY) - (before == MapSlotState::EMPTY);
+            occupiedCount += ((after & Detail::SLOT_OCCUPIED) != 0) - ((before & Detail::SLOT_OCCUPIED) != 0);
+            cells[index] = static_cast<Uint8>(value);
+        }
+
+        std::vector<Uint8> cells;
+        long indexOffsets[Direction::NO_DIRECTION + 1] = {}; // Detail::get_index_offset() for the current width
+        long widthCells = 0L;
+        long heightCells = 0L;
+        long emptyCount = 0L;
+        long occupiedCount = 0L;
+    }; // class DynamicGrid
+
+    // Board split into 64x64 chunks that are only allocated once written to. Each
+    // chunk keeps the empty count of its rows and each row of chunks its total,
+    // so memory, reset() and get_nth_empty() scale with the occupied part of the
+    // board rather than its area. Indices are row-major like the other grids.
+    class ChunkedGrid
+    {
+    public:
+        static constexpr long CHUNK_SHIFT = 6L;
+        static constexpr long CHUNK_SIZE = 1L << CHUNK_SHIFT;
+        static constexpr long CHUNK_MASK = CHUNK_SIZE - 1L;
+
+        ChunkedGrid() = default;
+        ChunkedGrid(const ChunkedGrid &other) { *this = other; }
+        ChunkedGrid &operator=(const ChunkedGrid &other)
+        {
+            if (this == &other)
+                return *this;
+            widthCells = heightCells = -1L; // forces reset() to resize
+            reset(other.widthCells, other.heightCells);
+            for (const Chunk *chunk : other.usedChunks)
+            {
+                Chunk *copy = allocate_chunk(chunk->slot);
+                *copy = *chunk;
+            }
+            bandEmptyCounts = other.bandEmptyCounts;
+            emptyCount = other.emptyCount;
+            occupiedCount = other.occupiedCount;
+            return *this;
+        }
+
+        void reset(const long &width, const long &height)
+        {
+            SDL_assert(width >= 0L && height >= 0L);
+            for (Chunk *chunk : usedChunks)
+            {
+                chunks[chunk->slot] = nullptr;
+                freeChunks.push_back(chunk);
+            }
+            usedChunks.clear();
+            if (width != widthCells || height != heightCells)
+            {
+                widthCells = width;
+                heightCells = height;
+                widthChunks = (width + CHUNK_MASK) >> CHUNK_SHIFT;
+                heightChunks = (height + CHUNK_MASK) >> CHUNK_SHIFT;
+                chunks.assign(static_cast<size_t>(widthChunks * heightChunks), nullptr);
+                bandEmptyCounts.resize(static_cast<size_t>(heightChunks));
+                for (const Direction direction : Detail::DIRECTIONS)
+                    indexOffsets[direction] = Detail::get_index_offset(direction, width);
+            }
+            for (long band = 0L; band < heightChunks; band++)
+                bandEmptyCounts[band] = std::min(CHUNK_SIZE, heightCells - (band << CHUNK_SHIFT)) * widthCells;
+            emptyCount = width * height;
+            occupiedCount = 0L;
+        }
+
+        long width() const { return widthCells; }
+        long height() const { return heightCells; }
+        long area() const { return widthCells * heightCells; }
+
+        bool is_in_bounds(const long &x, const long &y) const { return x >= 0L && y >= 0L && x < widthCells && y < heightCells; }
+        long to_index(const long &x, const long &y) const { return y * widthCells + x; }
+        void from_index(const long &index, long *x, long *y) const
+        {
+            *x = index % widthCells;
+            *y = index / widthCells;
+        }
+        void get_index_from_pos(const Position &pos, long *x, long *y) const
+        {
+            *x = Detail::get_column_from_pos(pos.x);
+            *y = Detail::get_row_from_pos(pos.y, heightCells);
+        }
+        Position get_pos_from_index(const long &x, const long &y) const { return Detail::get_pos_from_cell(x, y, heightCells); }
+
+        bool step(const long &index, const Direction &direction, long *next) const
+        {
+            long x, y;
+            from_index(index, &x, &y);
+            *next = index + indexOffsets[direction];
+            return direction != Direction::NO_DIRECTION && is_in_bounds(x + Detail::DIRECTION_DX[direction], y + Detail::DIRECTION_DY[direction]);
+        }
+        template <typename Func>
+        void for_each_neighbour(const long &index, Func &&func) const
+        {
+            for (const Direction direction : Detail::DIRECTIONS)
+            {
+                long next;
+                if (step(index, direction, &next))
+                    func(direction, next);
+            }
+        }
+
+        MapSlotState get(const long &index) const { return static_cast<MapSlotState>(read(index) & ~Detail::SLOT_MARK); }
+        void add(const long &index, const Uint8 &bits) { write(index, read(index) | bits); }
+        void remove(const long &index, const Uint8 &bits) { write(index, read(index) & ~bits); }
+
+        void mark(const long &index)
+        {
+            long x, y;
+            from_index(index, &x, &y);
+            get_or_allocate_chunk(x, y)->cells[get_cell(x, y)] |= Detail::SLOT_MARK;
+        }
+        void unmark(const long &index)
+        {
+            long x, y;
+            from_index(index, &x, &y);
+            if (Chunk *chunk = chunks[get_chunk_slot(x, y)])
+                chunk->cells[get_cell(x, y)] &= ~Detail::SLOT_MARK;
+        }
+        bool is_marked(const long &index) const { return read(index) & Detail::SLOT_MARK; }
+
+        long get_empty_count() const { return emptyCount; }
+        long get_occupied_count() const { return occupiedCount; } // slots with a snake head or body
+        long get_chunk_count() const { return static_cast<long>(usedChunks.size()); } // chunks allocated since reset()
+
+        // Skips whole rows of chunks, then whole rows of a chunk, by their empty counts.
+        long get_nth_empty(long n) const // in row-major order, -1 if there are not that many
+        {
+            if (n < 0L || n >= emptyCount)
+                return -1L;
+            long band = 0L;
+            for (; n >= bandEmptyCounts[band]; band++)
+                n -= bandEmptyCounts[band];
+            for (long y = band << CHUNK_SHIFT; y < heightCells; y++)
+            {
+                for (long chunkX = 0L; chunkX < widthChunks; chunkX++)
+                {
+                    const Chunk *chunk = chunks[band * widthChunks + chunkX];
+                    const long x0 = chunkX << CHUNK_SHIFT;
+                    const long rowEmptyCount = chunk ? chunk->rowEmptyCounts[y & CHUNK_MASK] : std::min(CHUNK_SIZE, widthCells - x0);
+                    if (n >= rowEmptyCount)
+                    {
+                        n -= rowEmptyCount;
+                        continue;
+                    }
+                    if (chunk == nullptr)
+                        return to_index(x0 + n, y);
+                    for (long x = x0; x < widthCells; x++)
+                    {
+                        if ((chunk->cells[get_cell(x, y)] & ~Detail::SLOT_MARK) == MapSlotState::EMPTY && n-- == 0L)
+                            return to_index(x, y);
+                    }
+                }
+            }
+            SDL_assert(false); // the empty counts are out of sync
+            return -1L;
+        }
+
+        bool operator==(const ChunkedGrid &other) const
+        {
+            if (widthCells != other.widthCells || heightCells != other.heightCells)
+                return false;
+            for (size_t slot = 0U; slot < chunks.size(); slot++)
+            {
+                const Chunk *chunk = chunks[slot];
+                const Chunk *otherChunk = other.chunks[slot];
+                if (chunk != nullptr && otherChunk != nullptr)
+                {
+                    if (chunk->cells != otherChunk->cells)
+                        return false;
+                }
+                else if (chunk != nullptr || otherChunk != nullptr)
+                {
+                    const Chunk *allocated = chunk != nullptr ? chunk : otherChunk;
+                    for (const Uint8 cell : allocated->cells)
+                    {
+                        if (cell != MapSlotState::EMPTY)
+                            return false;
+                    }
+                }
+            }
+            return true;
+        }
+        bool operator!=(const ChunkedGrid &other) const { return !(*this == other); }
+
+    private:
+        struct Chunk
+        {
+            std::array<Uint8, CHUNK_SIZE * CHUNK_SIZE> cells;
+            std::array<Uint8, CHUNK_SIZE> rowEmptyCounts; // empty slots of each row that are on the board
+            long slot;                                    // index into chunks
+        }; // struct Chunk
+
+        long get_chunk_slot(const long &x, const long &y) const { return (y >> CHUNK_SHIFT) * widthChunks + (x >> CHUNK_SHIFT); }
+        static long get_cell(const long &x, const long &y) { return ((y & CHUNK_MASK) << CHUNK_SHIFT) | (x & CHUNK_MASK); }
+
+        Uint8 read(const long &index) const
+        {
+            long x, y;
+            from_index(index, &x, &y);
+            const Chunk *chunk = chunks[get_chunk_slot(x, y)];
+            return chunk != nullptr ? chunk->cells[get_cell(x, y)] : static_cast<Uint8>(MapSlotState::EMPTY);
+        }
+        void write(const long &index, const Uint8 &value)
+        {
+            long x, y;
+            from_index(index, &x, &y);
+            Chunk *chunk = get_or_allocate_chunk(x, y);
+            Uint8 &cell = chunk->cells[get_cell(x, y)];
+            const Uint8 before = cell & ~Detail::SLOT_MARK;
+            const Uint8 after = value & ~Detail::SLOT_MARK;
+            const long emptyDelta = (after == MapSlotState::EMPTY) - (before == MapSlotState::EMPTY);
+            emptyCount += emptyDelta;
+            chunk->rowEmptyCounts[y & CHUNK_MASK] += emptyDelta;
+            bandEmptyCounts[y >> CHUNK_SHIFT] += emptyDelta;
+            occupiedCount += ((after & Detail::SLOT_OCCUPIED) != 0) - ((before & Detail::SLOT_OCCUPIED) != 0);
+            cell = static_cast<Uint8>(value);
+        }
+
+        Chunk *get_or_allocate_chunk(const long &x, const long &y)
+        {
+            const long slot = get_chunk_slot(x, y);
+            return chunks[slot] != nullptr ? chunks[slot] : allocate_chunk(slot);
+        }
+        Chunk *allocate_chunk(const long &slot)
+        {
+            if (freeChunks.empty())
+            {
+                chunkStorage.push_back(std::make_unique<Chunk>());
+                freeChunks.push_back(chunkStorage.back().get());
+            }
+            Chunk *chunk = freeChunks.back();
+            freeChunks.pop_back();
+            chunk->cells.fill(MapSlotState::EMPTY);
+            chunk->rowEmptyCounts.fill(static_cast<Uint8>(std::min(CHUNK_SIZE, widthCells - ((slot % widthChunks) << CHUNK_SHIFT))));
+            chunk->slot = slot;
+            chunks[slot] = chunk;
+            usedChunks.push_back(chunk);
+            return chunk;
+        }
+
+        std::vector<Chunk *> chunks; // widthChunks x heightChunks, nullptr where nothing was written
+        std::vector<Chunk *> usedChunks;
+        std::vector<Chunk *> freeChunks; // released by reset(), reused before allocating
+        std::vector<std::unique_ptr<Chunk>> chunkStorage;
+        std::vector<long> bandEmptyCounts; // per row of chunks
+        long indexOffsets[Direction::NO_DIRECTION + 1] = {};
+        long widthCells = 0L;
+        long heightCells = 0L;
+        long widthChunks = 0L;
+        long heightChunks = 0L;
+        long emptyCount = 0L;
+        long occupiedCount = 0L;
+    }; // class ChunkedGrid
+
+    // Board with the size fixed at compile time. Lives inline (no heap) and all
+    // index/position conversions are constexpr, so e.g. a 20x20 board is 400 bytes.
+    template <int WIDTH, int HEIGHT>
+    class FixedGrid
+    {
+        static_assert(WIDTH >= 1 && HEIGHT >= 1, "FixedGrid MUST be at least 1x1");
+
+    public:
+        static constexpr long AREA = static_cast<long>(WIDTH) * static_cast<long>(HEIGHT);
+        static constexpr long INDEX_OFFSETS[] = {
+            Detail::get_index_offset(Direction::UP, WIDTH),
+            Detail::get_index_offset(Direction::LEFT, WIDTH),
+            Detail::get_index_offset(Direction::DOWN, WIDTH),
+            Detail::get_index_offset(Direction::RIGHT, WIDTH),
+            Detail::get_index_offset(Direction::NO_DIRECTION, WIDTH),
+        };
+
+        void reset(const long &width, const long &height)
+        {
+            SDL_assert(width == WIDTH && height == HEIGHT); // SnakeBoundary2D MUST match the template arguments
+            cells.fill(MapSlotState::EMPTY);
+            emptyCount = AREA;
+            occupiedCount = 0L;
+        }
+
+        static constexpr long width() { return WIDTH; }
+        static constexpr long height() { return HEIGHT; }
+        static constexpr long area() { return AREA; }
+
+        static constexpr bool is_in_bounds(const long &x, const long &y) { return x >= 0L && y >= 0L && x < WIDTH && y < HEIGHT; }
+        static constexpr long to_index(const long &x, const long &y) { return y * WIDTH + x; }
+        static constexpr void from_index(const long &index, long *x, long *y)
+        {
+            *x = index % WIDTH;
+            *y = index / WIDTH;
+        }
+        static constexpr void get_index_from_pos(const Position &pos, long *x, long *y)
+        {
+            *x = Detail::get_column_from_pos(pos.x);
+            *y = Detail::get_row_from_pos(pos.y, HEIGHT);
+        }
+        static constexpr Position get_pos_from_index(const long &x, const long &y) { return Detail::get_pos_from_cell(x, y, HEIGHT); }
+
+        static constexpr bool step(const long &index, const Direction &direction, long *next)
+        {
+            long x = 0L, y = 0L;
+            from_index(index, &x, &y);
+            *next = index + INDEX_OFFSETS[direction];
+            return direction != Direction::NO_DIRECTION && is_in_bounds(x + Detail::DIRECTION_DX[direction], y + Detail::DIRECTION_DY[direction]);
+        }
+        // Unrolled at compile time; each bounds check only tests the side it can cross.
+        template <typename Func>
+        static constexpr void for_each_neighbour(const long &index, Func &&func)
+        {
+            for_each_neighbour(index, func, std::make_index_sequence<sizeof(Detail::DIRECTIONS)>{});
+        }
+
+        MapSlotState get(const long &index) const { return static_cast<MapSlotState>(cells[index] & ~Detail::SLOT_MARK); }
+        void add(const long &index, const Uint8 &bits) { write(index, cells[index] | bits); }
+        void remove(const long &index, const Uint8 &bits) { write(index, cells[index] & ~bits); }
+
+        void mark(const long &index) { cells[index] |= Detail::SLOT_MARK; }
+        void unmark(const long &index) { cells[index] &= ~Detail::SLOT_MARK; }
+        bool is_marked(const long &index) const { return cells[index] & Detail::SLOT_MARK; }
+
+        long get_empty_count() const { return emptyCount; }
+        long get_occupied_count() const { return occupiedCount; } // slots with a snake head or body
+        long get_nth_empty(long n) const // in row-major order, -1 if there are not that many
+        {
+            for (long index = 0L; index < AREA; index++)
+            {
+                if (get(index) == MapSlotState::EMPTY && n-- == 0L)
+                    return index;
+            }
+            return -1L;
+        }
+
+        bool operator==(const FixedGrid &other) const { return cells == other.cells; }
+        bool operator!=(const FixedGrid &other) const { return !(*this == other); }
+
+    private:
+        template <typename Func, size_t... I>
+        static constexpr void for_each_neighbour(const long &index, Func &func, std::index_sequence<I...>)
+        {
+            (visit_neighbour<Detail::DIRECTIONS[I]>(index, func), ...);
+        }
+        template <Direction DIRECTION, typename Func>
+        static constexpr void visit_neighbour(const long &index, Func &func)
+        {
+            constexpr long DX = Detail::DIRECTION_DX[DIRECTION];
+            constexpr long DY = Detail::DIRECTION_DY[DIRECTION];
+            const long x = index % WIDTH;
+            const long y = index / WIDTH;
+            if constexpr (DX < 0L)
+            {
+                if (x == 0L)
+                    return;
+            }
+            if constexpr (DX > 0L)
+            {
+                if (x == WIDTH - 1L)
+                    return;
+            }
+            if constexpr (DY < 0L)
+            {
+                if (y == 0L)
+                    return;
+            }
+            if constexpr (DY > 0L)
+            {
+                if (y == HEIGHT - 1L)
+                    return;
+            }
+            func(DIRECTION, index + INDEX_OFFSETS[DIRECTION]);
+        }
+
+        void write(const long &index, const Uint8 &value)
+        {
+            const Uint8 before = cells[index] & ~Detail::SLOT_MARK;
+            const Uint8 after = value & ~Detail::SLOT_MARK;
+            emptyCount += (after == MapSlotState::EMPTY) - (before == MapSlotState::EMPTY);
+            occupiedCount += ((after & Detail::SLOT_OCCUPIED) != 0) - ((before & Detail::SLOT_OCCUPIED) != 0);
+            cells[index] = static_cast<Uint8>(value);
+        }
+
+        std::array<Uint8, AREA> cells{};
+        long emptyCount = AREA;
+        long occupiedCount = 0L;
+    }; // class FixedGrid
+} // namespace SnakeGameplaySystem
+
+#endif // SRC_SYSTEM_SNAKE_GRID_HPP
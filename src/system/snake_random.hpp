@@ -0,0 +1,27 @@
+#ifndef SRC_SYSTEM_SNAKE_RANDOM_HPP
+#define SRC_SYSTEM_SNAKE_RANDOM_HPP
+
+#include <SDL3/SDL_stdinc.h>
+#include <entt/entt.hpp>
+
+#include <component/random_state.hpp>
+
+#include <system/resource.hpp>
+
+namespace SnakeGameplaySystem
+{
+    namespace Detail
+    {
+        // Uniform in [0, n), from the registry's RandomState if it has one so that
+        // registries on separate threads do not share SDL_rand()'s global state.
+        static Sint32 get_random(entt::registry &reg, const Sint32 &n)
+        {
+            RandomState *randomState = Resource::find<RandomState>(reg);
+            if (randomState == nullptr)
+                return SDL_rand(n);
+            return SDL_rand_r(&randomState->state, n);
+        }
+    } // namespace Detail
+} // namespace SnakeGameplaySystem
+
+#endif // SRC_SYSTEM_SNAKE_RANDOM_HPP
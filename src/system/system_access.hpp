@@ -0,0 +1,54 @@
+#ifndef SRC_SYSTEM_SYSTEM_ACCESS_HPP
+#define SRC_SYSTEM_SYSTEM_ACCESS_HPP
+
+#include <type_traits>
+#include <vector>
+
+#include <entt/entt.hpp>
+
+template <typename... Components>
+struct Reads
+{
+}; // struct Reads
+
+template <typename... Components>
+struct Writes
+{
+}; // struct Writes
+
+// Write it for systems that create or destroy entities, or add or remove
+// components; those touch every storage, so the system runs on its own.
+struct StructuralChange
+{
+}; // struct StructuralChange
+
+// Components and resources (see Resource) a system reads and writes, for SystemScheduler. Every system declares its own, e.g.
+//   using Access = SystemAccess<Reads<Velocity, DeltaTime>, Writes<Position>>;
+template <typename ReadList, typename WriteList>
+struct SystemAccess;
+
+template <typename... ReadComponents, typename... WriteComponents>
+struct SystemAccess<Reads<ReadComponents...>, Writes<WriteComponents...>>
+{
+    static constexpr bool IS_STRUCTURAL = (std::is_same_v<WriteComponents, StructuralChange> || ...);
+
+    static std::vector<entt::id_type> get_reads() { return {entt::type_hash<ReadComponents>::value()...}; }
+    static std::vector<entt::id_type> get_writes() { return {entt::type_hash<WriteComponents>::value()...}; }
+
+    // Creates the storages up front, so views made from several threads later only look them up.
+    static void assure_storages(entt::registry &reg)
+    {
+        (assure_storage<ReadComponents>(reg), ...);
+        (assure_storage<WriteComponents>(reg), ...);
+    }
+
+private:
+    template <typename Component>
+    static void assure_storage(entt::registry &reg)
+    {
+        if constexpr (!std::is_same_v<Component, StructuralChange>)
+            reg.storage<Component>();
+    }
+}; // struct SystemAccess
+
+#endif // SRC_SYSTEM_SYSTEM_ACCESS_HPP
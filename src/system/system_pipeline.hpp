@@ -0,0 +1,64 @@
+#ifndef SRC_SYSTEM_SYSTEM_PIPELINE_HPP
+#define SRC_SYSTEM_SYSTEM_PIPELINE_HPP
+
+#include <algorithm>
+#include <vector>
+
+#include <entt/entt.hpp>
+
+#include <system/resource.hpp>
+
+using SystemFunction = void (*)(entt::registry &);
+
+// Systems fixed at compile time, run in the order listed, e.g.
+//   using GameplayPipeline = SystemPipeline<SystemTranslate2D::iterate, SnakeGameplaySystem::iterate>;
+//   GameplayPipeline::iterate(reg);
+// Every call is direct, so unlike a sigslot::signal there is no slot list to
+// lock and walk, and the compiler is free to inline the systems.
+template <SystemFunction... SYSTEMS>
+struct SystemPipeline
+{
+    static void iterate(entt::registry &reg) { (SYSTEMS(reg), ...); }
+    static void update(entt::registry &reg) { return iterate(reg); }
+}; // struct SystemPipeline
+
+// Opt-in systems added at run time, per registry. List RuntimeSystems::iterate in a
+// pipeline where they should run; it does nothing for registries that have none.
+class RuntimeSystems
+{
+public:
+    static void iterate(entt::registry &reg)
+    {
+        if (const RuntimeSystems *runtimeSystems = Resource::find<RuntimeSystems>(reg))
+        {
+            for (const SystemFunction system : runtimeSystems->systems)
+                system(reg);
+        }
+    }
+
+    // Runs after the systems connected before it. False if it is connected already.
+    static bool connect(entt::registry &reg, const SystemFunction &system)
+    {
+        RuntimeSystems &runtimeSystems = Resource::get_or_emplace<RuntimeSystems>(reg);
+        if (std::find(runtimeSystems.systems.begin(), runtimeSystems.systems.end(), system) != runtimeSystems.systems.end())
+            return false;
+        runtimeSystems.systems.push_back(system);
+        return true;
+    }
+    static bool disconnect(entt::registry &reg, const SystemFunction &system)
+    {
+        RuntimeSystems *runtimeSystems = Resource::find<RuntimeSystems>(reg);
+        if (runtimeSystems == nullptr)
+            return false;
+        auto found = std::find(runtimeSystems->systems.begin(), runtimeSystems->systems.end(), system);
+        if (found == runtimeSystems->systems.end())
+            return false;
+        runtimeSystems->systems.erase(found);
+        return true;
+    }
+
+private:
+    std::vector<SystemFunction> systems;
+}; // class RuntimeSystems
+
+#endif // SRC_SYSTEM_SYSTEM_PIPELINE_HPP
@@ -0,0 +1,149 @@
+#ifndef SRC_SYSTEM_SYSTEM_SCHEDULER_HPP
+#define SRC_SYSTEM_SYSTEM_SCHEDULER_HPP
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <entt/entt.hpp>
+
+#include <system/resource.hpp>
+#include <system/system_access.hpp>
+#include <system/system_pipeline.hpp>
+#include <util/worker_pool.hpp>
+
+// Runs systems by the components they declare (see SystemAccess). Two systems
+// conflict when one writes what the other reads or writes; conflicting systems
+// run in the order they were added, the others may share a wave and run at the
+// same time on the registry's WorkerPool (Resource::set<WorkerPool *>()).
+//
+// The first iterate() on a registry runs every system in order on the calling
+// thread, so systems can set up their context state and storages safely.
+class SystemScheduler
+{
+public:
+    // False if the system was added already.
+    template <typename Access>
+    bool add(const SystemFunction &system)
+    {
+        for (const Entry &entry : entries)
+        {
+            if (entry.system == system)
+                return false;
+        }
+        entries.push_back(Entry{system, Access::get_reads(), Access::get_writes(), Access::IS_STRUCTURAL, &Access::assure_storages});
+        isBuilt = false;
+        version++;
+        return true;
+    }
+
+    void iterate(entt::registry &reg)
+    {
+        if (!isBuilt)
+            build();
+        if (!is_warmed_up(reg))
+        {
+            for (const Entry &entry : entries)
+                entry.assureStorages(reg);
+            for (const Entry &entry : entries)
+                entry.system(reg);
+            return;
+        }
+
+        WorkerPool **workerPool = Resource::find<WorkerPool *>(reg);
+        for (const std::vector<long> &wave : waves)
+        {
+            auto runWave = [this, &reg, &wave](const long &begin, const long &end)
+            {
+                for (long i = begin; i < end; i++)
+                    entries[wave[i]].system(reg);
+            };
+            if (workerPool != nullptr && wave.size() > 1U)
+                (*workerPool)->parallel_for(static_cast<long>(wave.size()), runWave);
+            else
+                runWave(0L, static_cast<long>(wave.size()));
+        }
+    }
+    void update(entt::registry &reg) { return iterate(reg); }
+
+    // Indices of the systems, in the order added, per wave.
+    const std::vector<std::vector<long>> &get_waves()
+    {
+        if (!isBuilt)
+            build();
+        return waves;
+    }
+
+private:
+    struct Entry
+    {
+        SystemFunction system;
+        std::vector<entt::id_type> reads;
+        std::vector<entt::id_type> writes;
+        bool isStructural;
+        void (*assureStorages)(entt::registry &);
+    }; // struct Entry
+
+    // Which schedulers have run a registry serially once already, at which version.
+    struct WarmedUp
+    {
+        std::vector<std::pair<const SystemScheduler *, unsigned long>> schedulers;
+    }; // struct WarmedUp
+
+    static bool is_touching(const std::vector<entt::id_type> &writes, const Entry &other)
+    {
+        for (const entt::id_type component : writes)
+        {
+            if (std::find(other.reads.begin(), other.reads.end(), component) != other.reads.end() ||
+                std::find(other.writes.begin(), other.writes.end(), component) != other.writes.end())
+                return true;
+        }
+        return false;
+    }
+    static bool is_conflicting(const Entry &a, const Entry &b)
+    {
+        return a.isStructural || b.isStructural || is_touching(a.writes, b) || is_touching(b.writes, a);
+    }
+
+    // A system goes in the wave after the latest one holding a system it conflicts with.
+    void build()
+    {
+        waves.clear();
+        std::vector<long> waveOf(entries.size(), 0L);
+        for (size_t i = 0U; i < entries.size(); i++)
+        {
+            for (size_t j = 0U; j < i; j++)
+            {
+                if (is_conflicting(entries[j], entries[i]))
+                    waveOf[i] = std::max(waveOf[i], waveOf[j] + 1L);
+            }
+            if (waveOf[i] >= static_cast<long>(waves.size()))
+                waves.resize(static_cast<size_t>(waveOf[i] + 1L));
+            waves[waveOf[i]].push_back(static_cast<long>(i));
+        }
+        isBuilt = true;
+    }
+
+    bool is_warmed_up(entt::registry &reg) const
+    {
+        WarmedUp &warmedUp = Resource::get_or_emplace<WarmedUp>(reg);
+        for (auto &scheduler : warmedUp.schedulers)
+        {
+            if (scheduler.first != this)
+                continue;
+            if (scheduler.second == version)
+                return true;
+            scheduler.second = version;
+            return false;
+        }
+        warmedUp.schedulers.emplace_back(this, version);
+        return false;
+    }
+
+    std::vector<Entry> entries;
+    std::vector<std::vector<long>> waves;
+    unsigned long version = 0UL;
+    bool isBuilt = false;
+}; // class SystemScheduler
+
+#endif // SRC_SYSTEM_SYSTEM_SCHEDULER_HPP
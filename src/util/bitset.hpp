@@ -0,0 +1,48 @@
+#ifndef SRC_UTIL_BITSET_HPP
+#define SRC_UTIL_BITSET_HPP
+
+#include <cstdint>
+#include <vector>
+
+// Bit array sized at run time. clear() only rewrites the words that were set
+// since the last clear(), so a large bitset used sparsely stays cheap to reuse.
+class Bitset
+{
+public:
+    void resize(const long &bitCount)
+    {
+        words.assign(static_cast<size_t>((bitCount + 63L) >> 6), 0U); // keeps capacity
+        touchedWords.clear();
+        bitCountTotal = bitCount;
+    }
+    long size() const { return bitCountTotal; }
+
+    bool test(const long &bit) const { return (words[bit >> 6] >> (bit & 63L)) & 1U; }
+    // Sets the bit and returns whether it was set already.
+    bool test_and_set(const long &bit)
+    {
+        std::uint64_t &word = words[bit >> 6];
+        const std::uint64_t mask = std::uint64_t{1U} << (bit & 63L);
+        if (word & mask)
+            return true;
+        if (word == 0U)
+            touchedWords.push_back(bit >> 6);
+        word |= mask;
+        return false;
+    }
+    void set(const long &bit) { test_and_set(bit); }
+
+    void clear()
+    {
+        for (const long word : touchedWords)
+            words[word] = 0U;
+        touchedWords.clear();
+    }
+
+private:
+    std::vector<std::uint64_t> words;
+    std::vector<long> touchedWords;
+    long bitCountTotal = 0L;
+}; // class Bitset
+
+#endif // SRC_UTIL_BITSET_HPP
@@ -0,0 +1,52 @@
+#ifndef SRC_UTIL_ROLLING_STATS_HPP
+#define SRC_UTIL_ROLLING_STATS_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+// The last N samples of a measurement. Percentiles are taken over that window
+// only, so a stutter shows up while it lasts and fades out after N samples.
+// Nothing is allocated; get_percentile() sorts a copy on the stack.
+template <size_t N>
+class RollingStats
+{
+public:
+    static_assert(N > 0U);
+
+    void add(const double &sample)
+    {
+        samples[next] = sample;
+        next = (next + 1U) % N;
+        count = std::min(count + 1U, N);
+    }
+    size_t size() const { return count; }
+    void clear() { next = count = 0U; }
+
+    // Nearest-rank percentile, 0.0 when there are no samples.
+    double get_percentile(const double &percent) const
+    {
+        if (count == 0U)
+            return 0.0;
+        std::array<double, N> sorted;
+        std::copy(samples.begin(), samples.begin() + count, sorted.begin());
+        size_t rank = static_cast<size_t>(std::ceil(percent / 100.0 * static_cast<double>(count)));
+        rank = std::min(std::max(rank, size_t{1U}), count);
+        std::nth_element(sorted.begin(), sorted.begin() + (rank - 1U), sorted.begin() + count);
+        return sorted[rank - 1U];
+    }
+    double get_max() const
+    {
+        if (count == 0U)
+            return 0.0;
+        return *std::max_element(samples.begin(), samples.begin() + count);
+    }
+
+private:
+    std::array<double, N> samples{};
+    size_t next = 0U;
+    size_t count = 0U;
+}; // class RollingStats
+
+#endif // SRC_UTIL_ROLLING_STATS_HPP
@@ -0,0 +1,41 @@
+#ifndef SRC_UTIL_SPSC_QUEUE_HPP
+#define SRC_UTIL_SPSC_QUEUE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Bounded queue for one producer thread and one consumer thread. Both sides are
+// wait-free: a push onto a full queue and a pop from an empty one fail at once.
+template <typename T, size_t CAPACITY>
+class SpscQueue
+{
+public:
+    static_assert(CAPACITY > 0U && (CAPACITY & (CAPACITY - 1U)) == 0U, "CAPACITY must be a power of two");
+
+    bool try_push(const T &value)
+    {
+        const size_t tail = tailIndex.load(std::memory_order_relaxed);
+        if (tail - headIndex.load(std::memory_order_acquire) == CAPACITY)
+            return false;
+        slots[tail & (CAPACITY - 1U)] = value;
+        tailIndex.store(tail + 1U, std::memory_order_release);
+        return true;
+    }
+    bool try_pop(T &value)
+    {
+        const size_t head = headIndex.load(std::memory_order_relaxed);
+        if (head == tailIndex.load(std::memory_order_acquire))
+            return false;
+        value = slots[head & (CAPACITY - 1U)];
+        headIndex.store(head + 1U, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::array<T, CAPACITY> slots{};
+    alignas(64) std::atomic<size_t> headIndex{0U}; // next slot to pop, only written by the consumer
+    alignas(64) std::atomic<size_t> tailIndex{0U}; // next slot to push, only written by the producer
+}; // class SpscQueue
+
+#endif // SRC_UTIL_SPSC_QUEUE_HPP
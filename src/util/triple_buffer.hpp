@@ -0,0 +1,42 @@
+#ifndef SRC_UTIL_TRIPLE_BUFFER_HPP
+#define SRC_UTIL_TRIPLE_BUFFER_HPP
+
+#include <array>
+#include <atomic>
+
+// Hands the latest value from one writer thread to one reader thread without
+// locks or waiting. Each side owns one buffer; the third is swapped between
+// them through an atomic index, with a bit telling whether it is newer than
+// what the reader has. Values the reader never took are simply overwritten.
+template <typename T>
+class TripleBuffer
+{
+public:
+    // Writer side. The buffer holds whatever was in it last, so write all of it.
+    T &get_write_buffer() { return buffers[writeIndex]; }
+    void publish()
+    {
+        writeIndex = middle.exchange(writeIndex | FRESH_BIT, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // Reader side. Takes the latest published value, if there is one it has not taken yet.
+    bool update()
+    {
+        if ((middle.load(std::memory_order_relaxed) & FRESH_BIT) == 0U)
+            return false;
+        readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+    const T &read() const { return buffers[readIndex]; }
+
+private:
+    static constexpr unsigned INDEX_MASK = 0b011U;
+    static constexpr unsigned FRESH_BIT = 0b100U;
+
+    std::array<T, 3U> buffers{};
+    unsigned writeIndex = 0U;
+    unsigned readIndex = 1U;
+    std::atomic<unsigned> middle{2U};
+}; // class TripleBuffer
+
+#endif // SRC_UTIL_TRIPLE_BUFFER_HPP
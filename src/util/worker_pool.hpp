@@ -0,0 +1,133 @@
+#ifndef SRC_UTIL_WORKER_POOL_HPP
+#define SRC_UTIL_WORKER_POOL_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Fixed set of threads for fork-join loops. The calling thread takes part in
+// every parallel_for(), so WorkerPool(0) simply runs everything in place, and
+// so does a parallel_for() issued while another one is running, e.g. from
+// inside one of its chunks.
+class WorkerPool
+{
+public:
+    explicit WorkerPool(const unsigned &workerCount = std::max(1U, std::thread::hardware_concurrency()) - 1U)
+    {
+        workers.reserve(workerCount);
+        for (unsigned i = 0U; i < workerCount; i++)
+            workers.emplace_back([this]
+                                 { work(); });
+    }
+    ~WorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            isStopping = true;
+        }
+        wakeUp.notify_all();
+        for (auto &worker : workers)
+            worker.join();
+    }
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    unsigned get_thread_count() const { return static_cast<unsigned>(workers.size()) + 1U; }
+
+    // Calls func(begin, end) over contiguous chunks of [0, count) and returns once
+    // every chunk is done. Nothing is allocated per call.
+    template <typename Func>
+    void parallel_for(const long &count, Func &&func)
+    {
+        if (count <= 0L)
+            return;
+        const long chunkCount = std::min<long>(count, get_thread_count());
+        if (chunkCount == 1L)
+        {
+            func(0L, count);
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        if (isRunning)
+        {
+            lock.unlock();
+            func(0L, count);
+            return;
+        }
+        isRunning = true;
+        job = {&call<std::remove_reference_t<Func>>, const_cast<void *>(static_cast<const void *>(&func)), count, chunkCount};
+        nextChunk = 0L;
+        pendingChunks = chunkCount;
+        generation++;
+        lock.unlock();
+        wakeUp.notify_all();
+
+        run_chunks();
+
+        lock.lock();
+        finished.wait(lock, [this]
+                      { return pendingChunks == 0L; });
+        isRunning = false;
+    }
+
+private:
+    struct Job
+    {
+        void (*invoke)(void *, long, long);
+        void *func;
+        long count;
+        long chunkCount;
+    }; // struct Job
+
+    template <typename Callable>
+    static void call(void *func, long begin, long end) { (*static_cast<Callable *>(func))(begin, end); }
+
+    void run_chunks()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (nextChunk < job.chunkCount)
+        {
+            const Job current = job;
+            const long chunk = nextChunk++;
+            lock.unlock();
+            current.invoke(current.func, chunk * current.count / current.chunkCount, (chunk + 1L) * current.count / current.chunkCount);
+            lock.lock();
+            if (--pendingChunks == 0L)
+                finished.notify_all();
+        }
+    }
+
+    void work()
+    {
+        unsigned long seenGeneration = 0UL;
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wakeUp.wait(lock, [this, &seenGeneration]
+                            { return isStopping || generation != seenGeneration; });
+                if (isStopping)
+                    return;
+                seenGeneration = generation;
+            }
+            run_chunks();
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::condition_variable finished;
+    Job job = {nullptr, nullptr, 0L, 0L};
+    long nextChunk = 0L;
+    long pendingChunks = 0L;
+    unsigned long generation = 0UL;
+    bool isRunning = false;
+    bool isStopping = false;
+}; // class WorkerPool
+
+#endif // SRC_UTIL_WORKER_POOL_HPP
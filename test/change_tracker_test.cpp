@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <component/position.hpp>
+#include <component/snake_apple.hpp>
+#include <component/snake_boundary_2d.hpp>
+#include <component/snake_part.hpp>
+#include <system/change_tracker.hpp>
+#include <system/resource.hpp>
+
+namespace
+{
+    std::vector<long> get_dirty_cells(const ChangeTracker &changeTracker, ChangeTracker::Cursor &cursor)
+    {
+        std::vector<long> ret;
+        EXPECT_TRUE(changeTracker.for_each_dirty_cell(cursor, [&ret](const long &cell)
+                                                      { ret.push_back(cell); }));
+        std::sort(ret.begin(), ret.end());
+        ret.erase(std::unique(ret.begin(), ret.end()), ret.end());
+        return ret;
+    }
+
+    TEST(ChangeTrackerTest, MoveDirtiesBothSlots)
+    {
+        entt::registry registry;
+        Resource::set<SnakeBoundary2D>(registry, 4, 4);
+        ChangeTracker &changeTracker = ChangeTracker::connect(registry);
+        const auto entity = registry.create();
+        registry.emplace<Position>(entity, 0.5f, 0.5f); // slot 12, the bottom row is the last
+        registry.emplace<SnakePart>(entity, 'd');
+
+        changeTracker.next_tick(registry);
+        ChangeTracker::Cursor cursor = changeTracker.get_cursor();
+        EXPECT_TRUE(changeTracker.is_unchanged_since(cursor));
+
+        registry.patch<Position>(entity, [](Position &pos)
+                                 { pos.x = 1.5f; });
+        EXPECT_FALSE(changeTracker.is_unchanged_since(cursor));
+        EXPECT_EQ(get_dirty_cells(changeTracker, cursor), (std::vector<long>{12L, 13L}));
+        EXPECT_TRUE(changeTracker.is_unchanged_since(cursor));
+
+        // Still caught up a tick later, and what changed in between is reported.
+        changeTracker.next_tick(registry);
+        registry.destroy(entity);
+        EXPECT_EQ(get_dirty_cells(changeTracker, cursor), (std::vector<long>{13L}));
+    }
+
+    TEST(ChangeTrackerTest, FallingBehindOrResizingMeansLookingAtEverything)
+    {
+        entt::registry registry;
+        Resource::set<SnakeBoundary2D>(registry, 4, 4);
+        ChangeTracker &changeTracker = ChangeTracker::connect(registry);
+        const auto apple = registry.create();
+        registry.emplace<Position>(apple, 0.5f, 0.5f);
+        registry.emplace<SnakeApple>(apple);
+
+        ChangeTracker::Cursor cursor = changeTracker.get_cursor();
+        changeTracker.next_tick(registry);
+        changeTracker.next_tick(registry);
+        EXPECT_FALSE(changeTracker.is_unchanged_since(cursor));
+        EXPECT_FALSE(changeTracker.for_each_dirty_cell(cursor, [](const long &) { FAIL(); }));
+        EXPECT_TRUE(changeTracker.is_unchanged_since(cursor)); // the cursor moved on anyway
+
+        Resource::get<SnakeBoundary2D>(registry) = SnakeBoundary2D{8, 8};
+        changeTracker.next_tick(registry);
+        EXPECT_FALSE(changeTracker.is_unchanged_since(cursor));
+        EXPECT_FALSE(changeTracker.for_each_dirty_cell(cursor, [](const long &) {}));
+
+        registry.patch<SnakeApple>(apple);
+        EXPECT_EQ(get_dirty_cells(changeTracker, cursor), (std::vector<long>{56L}));
+    }
+
+    // Positions written in place are reported a batch at a time: every entity, and slots only where they changed.
+    TEST(ChangeTrackerTest, LogMoved)
+    {
+        entt::registry registry;
+        Resource::set<SnakeBoundary2D>(registry, 4, 4);
+        ChangeTracker &changeTracker = ChangeTracker::connect(registry);
+        const entt::entity entities[] = {registry.create(), registry.create()};
+        registry.emplace<Position>(entities[0], 0.5f, 0.5f); // slot 12
+        registry.emplace<Position>(entities[1], 2.5f, 3.5f); // slot 2
+
+        changeTracker.next_tick(registry);
+        ChangeTracker::Cursor cursor = changeTracker.get_cursor();
+        const Position positions[] = {Position{1.5f, 0.5f}, Position{2.75f, 3.5f}}; // the second stays in its slot
+        changeTracker.log_moved(entities, positions, 2U);
+
+        std::vector<entt::entity> changedEntities;
+        ChangeTracker::Cursor entityCursor = cursor;
+        EXPECT_TRUE(changeTracker.for_each_changed_entity(entityCursor, [&changedEntities](const entt::entity &entity)
+                                                          { changedEntities.push_back(entity); }));
+        EXPECT_EQ(changedEntities, (std::vector<entt::entity>{entities[0], entities[1]}));
+        EXPECT_EQ(get_dirty_cells(changeTracker, cursor), (std::vector<long>{12L, 13L}));
+    }
+} // namespace
@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+
+#include <component/position.hpp>
+#include <component/snake_apple.hpp>
+#include <component/snake_part.hpp>
+#include <system/command_buffer.hpp>
+#include <system/resource.hpp>
+
+namespace
+{
+    TEST(CommandBufferTest, NothingHappensUntilApplied)
+    {
+        entt::registry registry;
+        const auto entity = registry.create();
+        CommandBuffer &commandBuffer = Resource::get_or_emplace<CommandBuffer>(registry);
+        EXPECT_TRUE(commandBuffer.empty());
+
+        commandBuffer.emplace<Position>(entity, 1.5f, 2.5f);
+        commandBuffer.emplace<SnakePart>(entity, 'w');
+        const CommandBuffer::Spawn spawn = commandBuffer.create();
+        commandBuffer.emplace<SnakeApple>(spawn);
+        EXPECT_FALSE(commandBuffer.empty());
+        EXPECT_FALSE(registry.all_of<Position>(entity));
+        EXPECT_TRUE(registry.view<SnakeApple>().empty());
+
+        CommandBuffer::flush(registry);
+        EXPECT_TRUE(commandBuffer.empty());
+        EXPECT_EQ(registry.get<Position>(entity).x, 1.5f);
+        EXPECT_EQ(registry.get<SnakePart>(entity).currentDirection, 'w');
+        EXPECT_EQ(registry.view<SnakeApple>().size(), 1U);
+    }
+
+    TEST(CommandBufferTest, LastEmplaceWins)
+    {
+        entt::registry registry;
+        const auto entity = registry.create();
+        registry.emplace<Position>(entity, 0.5f, 0.5f);
+
+        CommandBuffer &commandBuffer = Resource::get_or_emplace<CommandBuffer>(registry);
+        commandBuffer.emplace<Position>(entity, 1.5f, 0.5f);
+        commandBuffer.emplace<Position>(entity, 2.5f, 0.5f);
+        CommandBuffer::flush(registry);
+        EXPECT_EQ(registry.get<Position>(entity).x, 2.5f);
+    }
+
+    TEST(CommandBufferTest, DestroyWins)
+    {
+        entt::registry registry;
+        const auto kept = registry.create();
+        const auto destroyed = registry.create();
+        const auto gone = registry.create();
+        registry.destroy(gone);
+
+        CommandBuffer &commandBuffer = Resource::get_or_emplace<CommandBuffer>(registry);
+        commandBuffer.emplace<Position>(destroyed, 0.5f, 0.5f);
+        commandBuffer.destroy(destroyed);
+        commandBuffer.destroy(destroyed);
+        commandBuffer.emplace<Position>(gone, 0.5f, 0.5f); // skipped, like a second destroy
+        commandBuffer.destroy(gone);
+        commandBuffer.emplace<Position>(kept, 0.5f, 0.5f);
+        CommandBuffer::flush(registry);
+
+        EXPECT_TRUE(registry.valid(kept));
+        EXPECT_FALSE(registry.valid(destroyed));
+        EXPECT_EQ(registry.view<Position>().size(), 1U);
+    }
+} // namespace
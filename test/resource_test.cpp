@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+
+#include <component/delta_time.hpp>
+#include <component/key_control.hpp>
+#include <component/snake_boundary_2d.hpp>
+#include <system/resource.hpp>
+
+namespace
+{
+    TEST(ResourceTest, SetAndGet)
+    {
+        entt::registry registry;
+        EXPECT_EQ(Resource::find<KeyControl>(registry), nullptr);
+
+        Resource::set<KeyControl>(registry, 'd', false);
+        Resource::set<SnakeBoundary2D>(registry, 9, 7);
+        EXPECT_EQ(Resource::get<KeyControl>(registry).lastMovementKeyDown, 'd');
+        EXPECT_EQ(Resource::get<SnakeBoundary2D>(registry).x, 9);
+        EXPECT_EQ(Resource::get<SnakeBoundary2D>(registry).y, 7);
+
+        Resource::get<KeyControl>(registry).lastMovementKeyDown = 'w';
+        EXPECT_EQ(Resource::find<KeyControl>(registry)->lastMovementKeyDown, 'w');
+
+        // set() replaces the value, get_or_emplace() keeps it.
+        Resource::set<KeyControl>(registry, 'a', true);
+        EXPECT_EQ(Resource::get_or_emplace<KeyControl>(registry).lastMovementKeyDown, 'a');
+        EXPECT_TRUE(Resource::get<KeyControl>(registry).isShiftKeyDown);
+        EXPECT_EQ(Resource::get_or_emplace<DeltaTime>(registry).dt_ms, 0U);
+
+        // Resources are not entities; clearing the registry keeps them.
+        registry.clear();
+        EXPECT_NE(Resource::find<SnakeBoundary2D>(registry), nullptr);
+        EXPECT_TRUE(Resource::erase<SnakeBoundary2D>(registry));
+        EXPECT_EQ(Resource::find<SnakeBoundary2D>(registry), nullptr);
+        EXPECT_FALSE(Resource::erase<SnakeBoundary2D>(registry));
+    }
+
+    TEST(ResourceTest, PerRegistry)
+    {
+        entt::registry registry1, registry2;
+        Resource::set<DeltaTime>(registry1, 100U);
+        Resource::set<DeltaTime>(registry2, 16U);
+        EXPECT_EQ(Resource::get<DeltaTime>(registry1).dt_ms, 100U);
+        EXPECT_EQ(Resource::get<DeltaTime>(registry2).dt_ms, 16U);
+    }
+} // namespace
@@ -0,0 +1,41 @@
+#include <gtest/gtest.h>
+
+#include <util/rolling_stats.hpp>
+
+namespace
+{
+    TEST(RollingStatsTest, Percentiles)
+    {
+        RollingStats<100> stats;
+        EXPECT_EQ(stats.get_percentile(50.0), 0.0);
+        EXPECT_EQ(stats.get_max(), 0.0);
+
+        for (int i = 100; i >= 1; i--)
+            stats.add(static_cast<double>(i));
+        EXPECT_EQ(stats.size(), 100U);
+        EXPECT_EQ(stats.get_percentile(50.0), 50.0);
+        EXPECT_EQ(stats.get_percentile(99.0), 99.0);
+        EXPECT_EQ(stats.get_percentile(100.0), 100.0);
+        EXPECT_EQ(stats.get_percentile(0.0), 1.0);
+        EXPECT_EQ(stats.get_max(), 100.0);
+    }
+
+    TEST(RollingStatsTest, OldSamplesDropOut)
+    {
+        RollingStats<4> stats;
+        stats.add(1000.0);
+        for (int i = 0; i < 4; i++)
+            stats.add(1.0);
+        EXPECT_EQ(stats.size(), 4U);
+        EXPECT_EQ(stats.get_max(), 1.0);
+        EXPECT_EQ(stats.get_percentile(99.0), 1.0);
+
+        stats.add(3.0);
+        EXPECT_EQ(stats.get_percentile(50.0), 1.0);
+        EXPECT_EQ(stats.get_max(), 3.0);
+
+        stats.clear();
+        EXPECT_EQ(stats.size(), 0U);
+        EXPECT_EQ(stats.get_max(), 0.0);
+    }
+} // namespace
@@ -0,0 +1,243 @@
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include <component/position.hpp>
+#include <component/delta_time.hpp>
+#include <component/snake_apple.hpp>
+#include <component/snake_owner.hpp>
+#include <component/snake_part.hpp>
+#include <component/snake_part_head.hpp>
+#include <component/snake_boundary_2d.hpp>
+#include <system/translate_2d.hpp>
+#include <system/snake_arena_system.hpp>
+
+namespace
+{
+    using namespace SnakeGameplaySystem;
+
+    entt::registry create_arena(const int &width, const int &height)
+    {
+        entt::registry registry;
+        Resource::set<DeltaTime>(registry, 100U);
+        Resource::set<SnakeBoundary2D>(registry, width, height);
+        return registry;
+    }
+
+    void tick(entt::registry &registry)
+    {
+        SystemTranslate2D::update(registry);
+        SnakeArenaSystem::update(registry);
+    }
+
+    TEST(SnakeArenaSystemTest, HeadToHead)
+    {
+        entt::registry registry = create_arena(5, 3);
+        const auto left = SnakeArenaSystem::spawn_snake(registry, 1, 1, 'd', 10.0f, 1.0f); // 10 /s speed
+        const auto right = SnakeArenaSystem::spawn_snake(registry, 3, 1, 'a', 10.0f, 1.0f);
+        const auto bystander = SnakeArenaSystem::spawn_snake(registry, 0, 0, 's', 0.0f, 1.0f);
+        SnakeArenaSystem::init(registry);
+        SnakeArenaSystem::update(registry); // to set the velocities based on KeyControl
+        EXPECT_EQ(SnakeArenaSystem::get_snake_count(registry), 3UL);
+
+        tick(registry); // both heads enter (2, 1)
+        EXPECT_EQ(SnakeArenaSystem::get_dead_snakes(registry), (std::vector<entt::entity>{left, right}));
+        EXPECT_FALSE(registry.valid(left));
+        EXPECT_FALSE(registry.valid(right));
+        EXPECT_TRUE(registry.valid(bystander));
+        EXPECT_EQ(SnakeArenaSystem::get_snake_count(registry), 1UL);
+    }
+
+    TEST(SnakeArenaSystemTest, HeadsSwappingSlots)
+    {
+        entt::registry registry = create_arena(4, 3);
+        const auto left = SnakeArenaSystem::spawn_snake(registry, 1, 1, 'd', 10.0f, 1.0f); // 10 /s speed, no body
+        const auto right = SnakeArenaSystem::spawn_snake(registry, 2, 1, 'a', 10.0f, 1.0f);
+        SnakeArenaSystem::init(registry);
+        SnakeArenaSystem::update(registry);
+
+        tick(registry); // left enters (2, 1) as right enters (1, 1)
+        EXPECT_EQ(SnakeArenaSystem::get_dead_snakes(registry), (std::vector<entt::entity>{left, right}));
+        EXPECT_EQ(SnakeArenaSystem::get_snake_count(registry), 0UL);
+    }
+
+    TEST(SnakeArenaSystemTest, HeadToBodyAndTrailing)
+    {
+        entt::registry registry = create_arena(9, 5);
+        // Snake A lies along row 2 heading right; snake B comes down column 2 just behind its tail.
+        const auto headA = SnakeArenaSystem::spawn_snake(registry, 3, 2, 'd', 10.0f, 1.0f); // 10 /s speed
+        for (long x = 1; x <= 2; x++)
+        {
+            auto entity = registry.create();
+            registry.emplace<Position>(entity, Detail::get_pos_from_cell(x, 2, 5));
+            registry.emplace<SnakePart>(entity, 'd');
+            registry.emplace<SnakeOwner>(entity, headA);
+        }
+        const auto headB = SnakeArenaSystem::spawn_snake(registry, 2, 0, 's', 10.0f, 1.0f);
+        SnakeArenaSystem::init(registry);
+        SnakeArenaSystem::update(registry);
+        EXPECT_EQ(SnakeArenaSystem::get_score(registry, headA), 2UL);
+
+        tick(registry); // A: head (4, 2), body (3, 2) (2, 2); B: head (2, 1)
+        EXPECT_TRUE(SnakeArenaSystem::get_dead_snakes(registry).empty());
+        EXPECT_EQ(SnakeArenaSystem::get_score(registry, headA), 2UL);
+        {
+            const DynamicGrid &board = SnakeArenaSystem::get_board(registry);
+            EXPECT_EQ(board.get(board.to_index(4, 2)), MapSlotState::SNAKE_HEAD);
+            EXPECT_EQ(board.get(board.to_index(3, 2)), MapSlotState::SNAKE_BODY);
+            EXPECT_EQ(board.get(board.to_index(2, 2)), MapSlotState::SNAKE_BODY);
+            EXPECT_EQ(board.get(board.to_index(1, 2)), MapSlotState::EMPTY);
+            EXPECT_EQ(board.get(board.to_index(2, 1)), MapSlotState::SNAKE_HEAD);
+        }
+
+        tick(registry); // B enters (2, 2) as A's tail leaves it
+        EXPECT_TRUE(SnakeArenaSystem::get_dead_snakes(registry).empty());
+
+        registry.get<SnakePartHead>(headA).speed = 0.0f; // A stops with its body on (3, 2) (4, 2)
+        registry.get<KeyControl>(headB).lastMovementKeyDown = 'd';
+        SnakeArenaSystem::update(registry);
+        tick(registry); // B enters (3, 2)
+        EXPECT_EQ(SnakeArenaSystem::get_dead_snakes(registry), (std::vector<entt::entity>{headB}));
+        EXPECT_TRUE(registry.valid(headA));
+        EXPECT_FALSE(registry.valid(headB));
+        EXPECT_EQ(SnakeArenaSystem::get_score(registry, headA), 2UL);
+    }
+
+    TEST(SnakeArenaSystemTest, GrowOnApple)
+    {
+        entt::registry registry = create_arena(6, 3);
+        const auto head = SnakeArenaSystem::spawn_snake(registry, 1, 1, 'd', 10.0f, 1.0f);
+        auto apple = registry.create();
+        registry.emplace<Position>(apple, Detail::get_pos_from_cell(2, 1, 3));
+        registry.emplace<SnakeApple>(apple);
+        SnakeArenaSystem::init(registry);
+        SnakeArenaSystem::update(registry);
+
+        tick(registry);
+        EXPECT_EQ(SnakeArenaSystem::get_score(registry, head), 1UL);
+        const DynamicGrid &board = SnakeArenaSystem::get_board(registry);
+        EXPECT_EQ(board.get(board.to_index(1, 1)), MapSlotState::SNAKE_BODY);
+        long x, y;
+        board.get_index_from_pos(registry.get<Position>(apple), &x, &y);
+        EXPECT_TRUE(board.is_in_bounds(x, y));
+        EXPECT_EQ(board.get(board.to_index(x, y)), MapSlotState::APPLE);
+
+        registry.get<KeyControl>(head).lastMovementKeyDown = 'a'; // backwards into the new neck
+        SnakeArenaSystem::update(registry);
+        EXPECT_GT(registry.get<Velocity>(head).x, 0.0f);
+    }
+
+    // 64 bots steering at random; planning them on a WorkerPool changes nothing.
+    TEST(SnakeArenaSystemTest, ParallelMatchesSerial)
+    {
+        const char keys[] = {'w', 'a', 's', 'd'};
+        entt::registry serial = create_arena(64, 64), parallel = create_arena(64, 64);
+        WorkerPool workerPool(3U);
+        parallel.ctx().emplace<WorkerPool *>(&workerPool);
+        for (entt::registry *registry : {&serial, &parallel})
+        {
+            for (long i = 0; i < 64; i++)
+                SnakeArenaSystem::spawn_snake(*registry, (i % 8) * 8 + 3, (i / 8) * 8 + 3, keys[i % 4], 10.0f, 1.0f);
+            for (long i = 0; i < 32; i++)
+            {
+                auto apple = registry->create();
+                registry->emplace<Position>(apple, Detail::get_pos_from_cell((i * 13) % 64, (i * 29) % 64, 64));
+                registry->emplace<SnakeApple>(apple);
+            }
+            SnakeArenaSystem::init(*registry);
+        }
+
+        std::mt19937 serialInput(7U), parallelInput(7U);
+        unsigned long deathCount = 0UL;
+        for (int i = 0; i < 200; i++)
+        {
+            for (auto [registry, input] : {std::make_pair(&serial, &serialInput), std::make_pair(&parallel, &parallelInput)})
+            {
+                auto view = registry->view<SnakePartHead, KeyControl>();
+                for (auto &entity : view)
+                {
+                    if ((*input)() % 4U == 0U)
+                        view.get<KeyControl>(entity).lastMovementKeyDown = keys[(*input)() % 4U];
+                }
+                SDL_srand(static_cast<Uint64>(i));
+                tick(*registry);
+            }
+            EXPECT_EQ(SnakeArenaSystem::get_dead_snakes(serial), SnakeArenaSystem::get_dead_snakes(parallel));
+            ASSERT_TRUE(SnakeArenaSystem::get_board(serial) == SnakeArenaSystem::get_board(parallel));
+            deathCount += SnakeArenaSystem::get_dead_snakes(serial).size();
+        }
+        EXPECT_GT(deathCount, 0UL);
+        EXPECT_EQ(SnakeArenaSystem::get_snake_count(serial), 64UL - deathCount);
+    }
+
+    // Heads without bodies in a row: each enters the slot the one in front of it just left.
+    TEST(SnakeArenaSystemTest, HeadIntoSlotJustLeft)
+    {
+        entt::registry registry = create_arena(8, 3);
+        SnakeArenaSystem::spawn_snake(registry, 0, 0, 'd', 10.0f, 1.0f); // trailer made before its leader
+        SnakeArenaSystem::spawn_snake(registry, 1, 0, 'd', 10.0f, 1.0f);
+        SnakeArenaSystem::spawn_snake(registry, 1, 2, 'd', 10.0f, 1.0f);
+        SnakeArenaSystem::spawn_snake(registry, 0, 2, 'd', 10.0f, 1.0f); // and after it
+        SnakeArenaSystem::init(registry);
+        SnakeArenaSystem::update(registry);
+
+        for (long x = 1; x <= 4; x++)
+        {
+            tick(registry);
+            EXPECT_TRUE(SnakeArenaSystem::get_dead_snakes(registry).empty());
+            const DynamicGrid &board = SnakeArenaSystem::get_board(registry);
+            for (long y : {0L, 2L})
+            {
+                EXPECT_EQ(board.get(board.to_index(x, y)), MapSlotState::SNAKE_HEAD);
+                EXPECT_EQ(board.get(board.to_index(x + 1, y)), MapSlotState::SNAKE_HEAD);
+                EXPECT_EQ(board.get(board.to_index(x - 1, y)), MapSlotState::EMPTY);
+            }
+        }
+        EXPECT_EQ(SnakeArenaSystem::get_snake_count(registry), 4UL);
+    }
+
+    // The board is only patched where entities changed; it must still be what the registry holds.
+    TEST(SnakeArenaSystemTest, BoardFollowsRegistry)
+    {
+        const char keys[] = {'w', 'a', 's', 'd'};
+        entt::registry registry = create_arena(24, 24);
+        for (long i = 0; i < 36; i++)
+            SnakeArenaSystem::spawn_snake(registry, (i % 6) * 4 + 1, (i / 6) * 4 + 1, keys[i % 4], 10.0f, 1.0f);
+        for (long i = 0; i < 48; i++)
+        {
+            auto apple = registry.create();
+            registry.emplace<Position>(apple, Detail::get_pos_from_cell((i * 7) % 24, (i * 11) % 24, 24));
+            registry.emplace<SnakeApple>(apple);
+        }
+        SnakeArenaSystem::init(registry);
+
+        std::mt19937 input(11U);
+        DynamicGrid expected;
+        for (int i = 0; i < 300 && SnakeArenaSystem::get_snake_count(registry) > 0UL; i++)
+        {
+            auto view = registry.view<SnakePartHead, KeyControl>();
+            for (auto &entity : view)
+            {
+                if (input() % 3U == 0U)
+                    view.get<KeyControl>(entity).lastMovementKeyDown = keys[input() % 4U];
+            }
+            tick(registry);
+
+            expected.reset(24, 24);
+            auto add = [&registry, &expected](const entt::entity &entity, const Uint8 &bits)
+            {
+                long x, y;
+                expected.get_index_from_pos(registry.get<Position>(entity), &x, &y);
+                if (expected.is_in_bounds(x, y))
+                    expected.add(expected.to_index(x, y), bits);
+            };
+            for (auto &entity : registry.view<SnakePart, Position>())
+                add(entity, MapSlotState::SNAKE_BODY);
+            for (auto &entity : registry.view<SnakePartHead, Position>())
+                add(entity, MapSlotState::SNAKE_HEAD);
+            for (auto &entity : registry.view<SnakeApple, Position>())
+                add(entity, MapSlotState::APPLE);
+            ASSERT_TRUE(SnakeArenaSystem::get_board(registry) == expected) << "tick " << i;
+        }
+    }
+} // namespace
@@ -0,0 +1,218 @@
+#include <gtest/gtest.h>
+
+#include <component/position.hpp>
+#include <component/delta_time.hpp>
+#include <component/random_state.hpp>
+#include <component/snake_apple.hpp>
+#include <component/snake_autopilot.hpp>
+#include <component/snake_part_head.hpp>
+#include <component/snake_boundary_2d.hpp>
+#include <system/translate_2d.hpp>
+#include <system/snake_gameplay_system.hpp>
+#include <system/snake_arena_system.hpp>
+#include <system/snake_autopilot_system.hpp>
+
+namespace
+{
+    using namespace SnakeGameplaySystem;
+
+    SnakeAutopilotSystem::Occupancy create_occupancy(const long &width, const long &height)
+    {
+        SnakeAutopilotSystem::Occupancy occupancy;
+        occupancy.width = width;
+        occupancy.height = height;
+        occupancy.blocked.resize(width * height);
+        occupancy.apples.resize(width * height);
+        occupancy.pointed.resize(width * height);
+        return occupancy;
+    }
+
+    TEST(SnakeAutopilotSystemTest, ShortestPathToApple)
+    {
+        SnakeAutopilotSystem::Occupancy occupancy = create_occupancy(5, 5);
+        SnakeAutopilotSystem::Planner planner;
+        occupancy.apples.set(4 * 5 + 0); // bottom-left
+        occupancy.blocked.set(2 * 5 + 2);
+        EXPECT_EQ(SnakeAutopilotSystem::decide(occupancy, planner, 2 * 5 + 2, -1L), Direction::LEFT);
+        EXPECT_EQ(SnakeAutopilotSystem::decide(occupancy, planner, 0 * 5 + 4, -1L), Direction::LEFT);
+        EXPECT_EQ(SnakeAutopilotSystem::decide(occupancy, planner, 3 * 5 + 0, -1L), Direction::DOWN);
+    }
+
+    // B B B .
+    // @ $ B .
+    // B . . T   the apple is in a dead end, so go down and keep following the tail
+    TEST(SnakeAutopilotSystemTest, AvoidsDeadEnd)
+    {
+        SnakeAutopilotSystem::Occupancy occupancy = create_occupancy(4, 3);
+        SnakeAutopilotSystem::Planner planner;
+        for (const long index : {0L, 1L, 2L, 6L, 8L, 11L})
+            occupancy.blocked.set(index);
+        occupancy.apples.set(4);
+        occupancy.blocked.set(5); // head
+        EXPECT_EQ(SnakeAutopilotSystem::decide(occupancy, planner, 5L, 11L), Direction::DOWN);
+        EXPECT_EQ(SnakeAutopilotSystem::decide(occupancy, planner, 5L, -1L), Direction::LEFT); // no body to get stuck on
+
+        occupancy.blocked.set(9L); // every way is a dead end now; still pick a free slot
+        EXPECT_EQ(SnakeAutopilotSystem::decide(occupancy, planner, 5L, 11L), Direction::LEFT);
+    }
+
+    TEST(SnakeAutopilotSystemTest, PlaysSinglePlayerGame)
+    {
+        entt::registry registry;
+        {
+            Resource::set<KeyControl>(registry, 'd');
+            Resource::set<DeltaTime>(registry, 100U);
+            Resource::set<SnakeBoundary2D>(registry, 8, 8);
+
+            auto entityApple = registry.create();
+            registry.emplace<Position>(entityApple, 4.5f, 4.5f);
+            registry.emplace<SnakeApple>(entityApple);
+
+            auto entitySnakeHead = registry.create();
+            registry.emplace<Position>(entitySnakeHead, 1.5f, 1.5f);
+            registry.emplace<Velocity>(entitySnakeHead, 0.0f, 0.0f);
+            registry.emplace<SnakePartHead>(entitySnakeHead, 2.5f, 1.0f); // a quarter of a slot per tick
+            registry.emplace<SnakeAutopilot>(entitySnakeHead);
+        }
+        SDL_srand(1U);
+        SnakeGameplaySystem::init(registry);
+        for (int i = 0; i < 4000 && !SnakeGameplaySystem::is_game_failure(registry) && !SnakeGameplaySystem::is_game_success(registry); i++)
+        {
+            SystemTranslate2D::update(registry);
+            SnakeGameplaySystem::update(registry);
+            SnakeAutopilotSystem::update(registry);
+        }
+        EXPECT_FALSE(SnakeGameplaySystem::is_game_failure(registry));
+        EXPECT_GE(SnakeGameplaySystem::get_score(registry), 20UL);
+    }
+
+    TEST(SnakeAutopilotSystemTest, CycleFillsBoard)
+    {
+        for (const int size : {4, 6, 10})
+        {
+            entt::registry registry;
+            Resource::set<KeyControl>(registry, 'd');
+            Resource::set<DeltaTime>(registry, 100U);
+            Resource::set<SnakeBoundary2D>(registry, size, size);
+
+            auto entityApple = registry.create();
+            registry.emplace<Position>(entityApple, Detail::get_pos_from_cell(size - 1, size - 1, size));
+            registry.emplace<SnakeApple>(entityApple);
+
+            auto entitySnakeHead = registry.create();
+            registry.emplace<Position>(entitySnakeHead, Detail::get_pos_from_cell(1, 1, size));
+            registry.emplace<Velocity>(entitySnakeHead, 0.0f, 0.0f);
+            registry.emplace<SnakePartHead>(entitySnakeHead, 2.5f, 1.0f);
+            registry.emplace<SnakeAutopilot>(entitySnakeHead, SnakeAutopilot::HAMILTONIAN_CYCLE);
+
+            SDL_srand(static_cast<Uint64>(size));
+            SnakeGameplaySystem::init(registry);
+            const long tickLimit = 4L * size * size * size * size;
+            for (long i = 0; i < tickLimit && !SnakeGameplaySystem::is_game_failure(registry) && !SnakeGameplaySystem::is_game_success(registry); i++)
+            {
+                SystemTranslate2D::update(registry);
+                SnakeGameplaySystem::update(registry);
+                SnakeAutopilotSystem::update(registry);
+            }
+            EXPECT_TRUE(SnakeGameplaySystem::is_game_success(registry)) << size << "x" << size;
+        }
+    }
+
+    // A RandomState makes apple respawns independent of SDL_rand()'s global state.
+    TEST(SnakeAutopilotSystemTest, SeededGamesReplay)
+    {
+        entt::registry first, second;
+        for (entt::registry *registry : {&first, &second})
+        {
+            Resource::set<KeyControl>(*registry, 'd');
+            Resource::set<DeltaTime>(*registry, 100U);
+            Resource::set<SnakeBoundary2D>(*registry, 8, 8);
+            Resource::set<RandomState>(*registry, 42U);
+
+            auto entityApple = registry->create();
+            registry->emplace<Position>(entityApple, 4.5f, 4.5f);
+            registry->emplace<SnakeApple>(entityApple);
+
+            auto entitySnakeHead = registry->create();
+            registry->emplace<Position>(entitySnakeHead, 1.5f, 1.5f);
+            registry->emplace<Velocity>(entitySnakeHead, 0.0f, 0.0f);
+            registry->emplace<SnakePartHead>(entitySnakeHead, 2.5f, 1.0f);
+            registry->emplace<SnakeAutopilot>(entitySnakeHead);
+            SnakeGameplaySystem::init(*registry);
+        }
+        for (int i = 0; i < 1000; i++)
+        {
+            for (entt::registry *registry : {&first, &second})
+            {
+                SDL_srand(registry == &first ? 1U : 2U);
+                SystemTranslate2D::update(*registry);
+                SnakeGameplaySystem::update(*registry);
+                SnakeAutopilotSystem::update(*registry);
+            }
+            ASSERT_TRUE(SnakeGameplaySystem::get_board(first) == SnakeGameplaySystem::get_board(second));
+        }
+        EXPECT_GE(SnakeGameplaySystem::get_score(first), 10UL);
+    }
+
+    // Heads without a KeyControl of their own all write the resource: the last head wins, threads or not.
+    TEST(SnakeAutopilotSystemTest, SharedKeyControl)
+    {
+        WorkerPool workerPool(3U);
+        for (const bool isParallel : {false, true})
+        {
+            entt::registry registry;
+            if (isParallel)
+                registry.ctx().emplace<WorkerPool *>(&workerPool);
+            Resource::set<KeyControl>(registry, 's');
+            Resource::set<SnakeBoundary2D>(registry, 8, 8);
+            for (long i = 0; i < 8; i++)
+            {
+                // With nothing to chase a head goes up if it can: all but the last one, on the top row.
+                const auto head = SnakeArenaSystem::spawn_snake(registry, i, i < 7 ? 7 : 0, 's', 1.0f, 1.0f);
+                registry.remove<KeyControl>(head);
+                registry.emplace<SnakeAutopilot>(head);
+            }
+            SnakeAutopilotSystem::update(registry);
+            EXPECT_EQ(Resource::get<KeyControl>(registry).lastMovementKeyDown, 'a');
+        }
+    }
+
+    // Many bots on a large arena; planning on a WorkerPool changes nothing.
+    TEST(SnakeAutopilotSystemTest, ArenaBotsInParallel)
+    {
+        entt::registry serial, parallel;
+        WorkerPool workerPool(3U);
+        parallel.ctx().emplace<WorkerPool *>(&workerPool);
+        for (entt::registry *registry : {&serial, &parallel})
+        {
+            Resource::set<DeltaTime>(*registry, 100U);
+            Resource::set<SnakeBoundary2D>(*registry, 256, 256);
+            for (long i = 0; i < 256; i++)
+            {
+                registry->emplace<SnakeAutopilot>(SnakeArenaSystem::spawn_snake(*registry, (i % 16) * 16 + 8, (i / 16) * 16 + 8, 'd', 2.5f, 1.0f));
+                auto apple = registry->create();
+                registry->emplace<Position>(apple, Detail::get_pos_from_cell((i % 16) * 16 + 3, (i / 16) * 16 + 12, 256));
+                registry->emplace<SnakeApple>(apple);
+            }
+            SnakeArenaSystem::init(*registry);
+        }
+
+        for (int i = 0; i < 200; i++)
+        {
+            for (entt::registry *registry : {&serial, &parallel})
+            {
+                SDL_srand(static_cast<Uint64>(i));
+                SystemTranslate2D::update(*registry);
+                SnakeArenaSystem::update(*registry);
+                SnakeAutopilotSystem::update(*registry);
+            }
+            ASSERT_TRUE(SnakeArenaSystem::get_board(serial) == SnakeArenaSystem::get_board(parallel));
+        }
+        unsigned long totalScore = 0UL;
+        auto view = serial.view<SnakePartHead>();
+        for (auto &entity : view)
+            totalScore += SnakeArenaSystem::get_score(serial, entity);
+        EXPECT_GE(SnakeArenaSystem::get_snake_count(serial), 200UL);
+        EXPECT_GE(totalScore, 256UL);
+    }
+} // namespace
@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <SDL3/SDL_stdinc.h>
+
+#include <snake_batch_env.h>
+
+namespace
+{
+    TEST(SnakeBatchEnvTest, Create)
+    {
+        EXPECT_EQ(snake_batch_env_create(0, 8, 8, 1U, 1), nullptr);
+        EXPECT_EQ(snake_batch_env_create(4, 0, 8, 1U, 1), nullptr);
+        SnakeBatchEnv *env = snake_batch_env_create(4, 8, 6, 1U, 2);
+        ASSERT_NE(env, nullptr);
+
+        std::vector<uint8_t> observations(4 * 6 * 8, 0xFFU);
+        EXPECT_EQ(snake_batch_env_reset(env, observations.data()), 0);
+        for (int i = 0; i < 4; i++)
+        {
+            int heads = 0, apples = 0, others = 0;
+            for (int j = 0; j < 6 * 8; j++)
+            {
+                const uint8_t slot = observations[i * 6 * 8 + j];
+                heads += slot == 1U;
+                apples += slot == 4U;
+                others += slot != 0U && slot != 1U && slot != 4U;
+            }
+            EXPECT_EQ(heads, 1);
+            EXPECT_EQ(apples, 1);
+            EXPECT_EQ(others, 0);
+        }
+        // The head starts in the 3rd column, a row below the apple.
+        EXPECT_EQ(observations[3 * 8 + 2], 1U);
+        snake_batch_env_destroy(env);
+    }
+
+    // The head starts in the 3rd column, so narrower boards would start every game lost.
+    TEST(SnakeBatchEnvTest, NarrowBoards)
+    {
+        EXPECT_EQ(snake_batch_env_create(2, 1, 6, 1U, 1), nullptr);
+        EXPECT_EQ(snake_batch_env_create(2, 2, 6, 1U, 1), nullptr);
+        SnakeBatchEnv *env = snake_batch_env_create(2, 3, 6, 1U, 1);
+        ASSERT_NE(env, nullptr);
+
+        std::vector<uint8_t> observations(2 * 6 * 3, 0xFFU);
+        EXPECT_EQ(snake_batch_env_reset(env, observations.data()), 0);
+        for (int i = 0; i < 2; i++)
+            EXPECT_EQ(observations[i * 6 * 3 + 3 * 3 + 2], 1U);
+        snake_batch_env_destroy(env);
+    }
+
+    // Same seed, same games, whatever the number of threads; ended games start over.
+    TEST(SnakeBatchEnvTest, StepsAndAutoResets)
+    {
+        constexpr int BATCH = 16, WIDTH = 7, HEIGHT = 5;
+        SnakeBatchEnv *serial = snake_batch_env_create(BATCH, WIDTH, HEIGHT, 7U, 1);
+        SnakeBatchEnv *parallel = snake_batch_env_create(BATCH, WIDTH, HEIGHT, 7U, 4);
+        std::vector<uint8_t> actions(BATCH), dones[2] = {std::vector<uint8_t>(BATCH), std::vector<uint8_t>(BATCH)};
+        std::vector<float> rewards[2] = {std::vector<float>(BATCH), std::vector<float>(BATCH)};
+        std::vector<uint8_t> observations[2] = {std::vector<uint8_t>(BATCH * WIDTH * HEIGHT), std::vector<uint8_t>(BATCH * WIDTH * HEIGHT)};
+        EXPECT_EQ(snake_batch_env_reset(serial, observations[0].data()), 0);
+        EXPECT_EQ(snake_batch_env_reset(parallel, observations[1].data()), 0);
+
+        Uint64 randomState = 3U;
+        int doneCount = 0, appleCount = 0, deathCount = 0;
+        for (int step = 0; step < 500; step++)
+        {
+            for (auto &action : actions)
+                action = static_cast<uint8_t>(SDL_rand_r(&randomState, 5));
+            ASSERT_EQ(snake_batch_env_step(serial, actions.data(), rewards[0].data(), dones[0].data(), observations[0].data()), 0);
+            ASSERT_EQ(snake_batch_env_step(parallel, actions.data(), rewards[1].data(), dones[1].data(), observations[1].data()), 0);
+            ASSERT_EQ(observations[0], observations[1]);
+            ASSERT_EQ(rewards[0], rewards[1]);
+            ASSERT_EQ(dones[0], dones[1]);
+            for (int i = 0; i < BATCH; i++)
+            {
+                doneCount += dones[0][i];
+                appleCount += rewards[0][i] > 0.0f;
+                deathCount += rewards[0][i] < 0.0f;
+                EXPECT_TRUE(dones[0][i] || rewards[0][i] >= 0.0f);
+                if (dones[0][i]) // already the first observation of the next game
+                {
+                    EXPECT_EQ(observations[0][i * WIDTH * HEIGHT + 3 * WIDTH + 2], 1U);
+                }
+            }
+        }
+        EXPECT_GT(doneCount, BATCH);
+        EXPECT_GT(appleCount, 0);
+        EXPECT_GT(deathCount, 0);
+        snake_batch_env_destroy(serial);
+        snake_batch_env_destroy(parallel);
+    }
+} // namespace
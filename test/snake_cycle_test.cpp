@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <system/snake_cycle.hpp>
+
+namespace
+{
+    using namespace SnakeGameplaySystem;
+
+    void expect_cycle(const HamiltonianCycle &cycle, const long &width, const long &height)
+    {
+        ASSERT_EQ(cycle.area(), width * height);
+        std::vector<bool> isVisited(width * height, false);
+        for (long position = 0L; position < cycle.area(); position++)
+        {
+            const long slot = cycle.get_slot(position);
+            const long next = cycle.get_slot((position + 1L) % cycle.area());
+            ASSERT_FALSE(isVisited[slot]);
+            isVisited[slot] = true;
+            EXPECT_EQ(cycle.get_position(slot), position);
+            EXPECT_EQ(cycle.get_distance(slot, next), 1L);
+            EXPECT_EQ(std::abs(slot % width - next % width) + std::abs(slot / width - next / width), 1L);
+        }
+    }
+
+    TEST(SnakeCycleTest, BoardSizes)
+    {
+        for (const auto &size : std::vector<std::pair<long, long>>{{1, 2}, {2, 1}, {2, 2}, {4, 4}, {6, 3}, {3, 6}, {7, 10}, {16, 9}, {64, 64}})
+        {
+            HamiltonianCycle cycle;
+            ASSERT_TRUE(cycle.build(size.first, size.second));
+            expect_cycle(cycle, size.first, size.second);
+        }
+        for (const auto &size : std::vector<std::pair<long, long>>{{1, 1}, {1, 4}, {3, 1}, {3, 3}, {5, 7}})
+        {
+            HamiltonianCycle cycle;
+            EXPECT_FALSE(cycle.build(size.first, size.second));
+            EXPECT_TRUE(cycle.empty());
+            EXPECT_EQ(get_hamiltonian_cycle(size.first, size.second), nullptr);
+        }
+        EXPECT_EQ(get_hamiltonian_cycle(8, 6), get_hamiltonian_cycle(8, 6)); // built once
+    }
+
+    TEST(SnakeCycleTest, SaveAndLoad)
+    {
+        const std::string path = testing::TempDir() + "snake_cycle_test.bin";
+        HamiltonianCycle built, loaded;
+        ASSERT_TRUE(built.build(10, 7));
+        ASSERT_TRUE(built.save(path));
+        EXPECT_FALSE(loaded.load(path, 7, 10));
+        ASSERT_TRUE(loaded.load(path, 10, 7));
+        EXPECT_TRUE(loaded == built);
+        expect_cycle(loaded, 10, 7);
+
+        { // swap two slots so consecutive ones are no longer adjacent
+            std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+            const Uint32 slots[2] = {static_cast<Uint32>(built.get_slot(5)), static_cast<Uint32>(built.get_slot(1))};
+            file.seekp(3 * sizeof(Uint32) + sizeof(Uint32));
+            file.write(reinterpret_cast<const char *>(slots), sizeof(slots));
+        }
+        EXPECT_FALSE(loaded.load(path, 10, 7));
+        EXPECT_TRUE(loaded.empty());
+        EXPECT_FALSE(loaded.load(path + ".missing", 10, 7));
+        std::remove(path.c_str());
+    }
+
+    TEST(SnakeCycleTest, DiskCache)
+    {
+        set_cycle_cache_directory(testing::TempDir());
+        const std::string path = testing::TempDir() + "/cycle_12x5.bin";
+        std::remove(path.c_str());
+        auto cycle = get_hamiltonian_cycle(12, 5);
+        set_cycle_cache_directory("");
+        ASSERT_NE(cycle, nullptr);
+
+        HamiltonianCycle loaded;
+        ASSERT_TRUE(loaded.load(path, 12, 5));
+        EXPECT_TRUE(loaded == *cycle);
+        std::remove(path.c_str());
+    }
+} // namespace
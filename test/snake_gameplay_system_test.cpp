@@ -19,10 +19,9 @@ namespace
     TEST(SnakeGameplaySystemTest, ValidChangeDirection)
     {
         entt::registry registry;
-        auto entity = registry.create();
-        registry.emplace<KeyControl>(entity);
-        registry.emplace<DeltaTime>(entity, 5000U);
-        registry.emplace<SnakeBoundary2D>(entity, 20, 20);
+        Resource::set<KeyControl>(registry);
+        Resource::set<DeltaTime>(registry, 5000U);
+        Resource::set<SnakeBoundary2D>(registry, 20, 20);
 
         auto entitySnakeHead = registry.create();
         registry.emplace<Position>(entitySnakeHead, 10.0f, 10.0f);
@@ -53,10 +52,9 @@ namespace
     TEST(SnakeGameplaySystemTest, SpeedUpVelocity)
     {
         entt::registry registry;
-        auto entity = registry.create();
-        registry.emplace<KeyControl>(entity, false);
-        registry.emplace<DeltaTime>(entity, 5000U);
-        registry.emplace<SnakeBoundary2D>(entity, 20, 20);
+        Resource::set<KeyControl>(registry, false);
+        Resource::set<DeltaTime>(registry, 5000U);
+        Resource::set<SnakeBoundary2D>(registry, 20, 20);
 
         auto entitySnakeHead = registry.create();
         registry.emplace<Position>(entitySnakeHead, 10.0f, 10.0f);
@@ -108,10 +106,9 @@ namespace
     TEST(SnakeGameplaySystemTest, InvalidChangeDirection)
     {
         entt::registry registry;
-        auto entity = registry.create();
-        registry.emplace<KeyControl>(entity);
-        registry.emplace<DeltaTime>(entity, 5000U);
-        registry.emplace<SnakeBoundary2D>(entity, 20, 20);
+        Resource::set<KeyControl>(registry);
+        Resource::set<DeltaTime>(registry, 5000U);
+        Resource::set<SnakeBoundary2D>(registry, 20, 20);
 
         auto entitySnakeHead = registry.create();
         registry.emplace<Position>(entitySnakeHead, 10.5f, 10.5f);
@@ -273,10 +270,9 @@ namespace
     TEST(SnakeGameplaySystemUtilTest, GetMap)
     {
         entt::registry registry;
-        auto entity = registry.create();
-        registry.emplace<KeyControl>(entity);
-        registry.emplace<DeltaTime>(entity, 5000U);
-        registry.emplace<SnakeBoundary2D>(entity, 6, 5);
+        Resource::set<KeyControl>(registry);
+        Resource::set<DeltaTime>(registry, 5000U);
+        Resource::set<SnakeBoundary2D>(registry, 6, 5);
 
         auto entitySnakeHead = registry.create();
         registry.emplace<Position>(entitySnakeHead, 0.0f, 0.0f);
@@ -326,10 +322,9 @@ namespace
     {
         entt::registry registry1; // 1x1 map with snake head in middle
         {
-            auto entity = registry1.create();
-            registry1.emplace<KeyControl>(entity);
-            registry1.emplace<DeltaTime>(entity, 5000U);
-            registry1.emplace<SnakeBoundary2D>(entity, 1, 1);
+            Resource::set<KeyControl>(registry1);
+            Resource::set<DeltaTime>(registry1, 5000U);
+            Resource::set<SnakeBoundary2D>(registry1, 1, 1);
 
             auto entitySnakeHead = registry1.create();
             registry1.emplace<Position>(entitySnakeHead, 0.5f, 0.5f);
@@ -340,10 +335,9 @@ namespace
 
         entt::registry registry2; // 2x1 map with snake head on left and body on right
         {
-            auto entity = registry2.create();
-            registry2.emplace<KeyControl>(entity);
-            registry2.emplace<DeltaTime>(entity, 5000U);
-            registry2.emplace<SnakeBoundary2D>(entity, 2, 1);
+            Resource::set<KeyControl>(registry2);
+            Resource::set<DeltaTime>(registry2, 5000U);
+            Resource::set<SnakeBoundary2D>(registry2, 2, 1);
 
             auto entitySnakeHead = registry2.create();
             registry2.emplace<Position>(entitySnakeHead, 0.5f, 0.5f);
@@ -360,10 +354,9 @@ namespace
     {
         entt::registry registry1; // 2x1 map with snake head at out-of-bounds
         {
-            auto entity = registry1.create();
-            registry1.emplace<KeyControl>(entity, 'a');
-            registry1.emplace<DeltaTime>(entity, 100U);
-            registry1.emplace<SnakeBoundary2D>(entity, 2, 1);
+            Resource::set<KeyControl>(registry1, 'a');
+            Resource::set<DeltaTime>(registry1, 100U);
+            Resource::set<SnakeBoundary2D>(registry1, 2, 1);
 
             auto entitySnakeHead = registry1.create();
             registry1.emplace<Position>(entitySnakeHead, -1.5f, -1.5f);
@@ -373,10 +366,9 @@ namespace
 
         entt::registry registry2; // 2x1 map with snake head + body at left
         {
-            auto entity = registry2.create();
-            registry2.emplace<KeyControl>(entity, 'a');
-            registry2.emplace<DeltaTime>(entity, 100U);
-            registry2.emplace<SnakeBoundary2D>(entity, 2, 1);
+            Resource::set<KeyControl>(registry2, 'a');
+            Resource::set<DeltaTime>(registry2, 100U);
+            Resource::set<SnakeBoundary2D>(registry2, 2, 1);
 
             auto entitySnakeHead = registry2.create();
             registry2.emplace<Position>(entitySnakeHead, 0.5f, 0.5f);
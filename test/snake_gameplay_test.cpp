@@ -1,3 +1,5 @@
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include <component/position.hpp>
@@ -6,6 +8,7 @@
 #include <component/snake_part_head.hpp>
 #include <component/snake_boundary_2d.hpp>
 #include <component/snake_apple.hpp>
+#include <system/command_buffer.hpp>
 #include <system/translate_2d.hpp>
 #include <system/snake_gameplay_system.hpp>
 
@@ -14,11 +17,10 @@ namespace
     TEST(SnakeGameplaySystemTest, TrailingOrthogonallyWithoutApple)
     {
         entt::registry registry;
-        { // create game state entity; 3x1 map
-            auto entity = registry.create();
-            registry.emplace<KeyControl>(entity, 'd');
-            registry.emplace<DeltaTime>(entity, 100U);
-            registry.emplace<SnakeBoundary2D>(entity, 3, 1);
+        { // game state resources; 3x1 map
+            Resource::set<KeyControl>(registry, 'd');
+            Resource::set<DeltaTime>(registry, 100U);
+            Resource::set<SnakeBoundary2D>(registry, 3, 1);
         }
         { // create snake head
             auto entity = registry.create();
@@ -48,14 +50,159 @@ namespace
         EXPECT_TRUE(SnakeGameplaySystem::get_map(registry) == comp);
     }
 
-    TEST(SnakeGameplaySystemTest, TrailingDiagonallyWithoutApple)
+    // Moving without an apple turns the tail into the new neck rather than replacing it.
+    TEST(SnakeGameplaySystemTest, TrailingReusesTail)
     {
         entt::registry registry;
-        { // create game state entity; 2x2 map
+        { // game state resources; 6x1 map
+            Resource::set<KeyControl>(registry, 'd');
+            Resource::set<DeltaTime>(registry, 100U);
+            Resource::set<SnakeBoundary2D>(registry, 6, 1);
+        }
+        { // create snake head
             auto entity = registry.create();
-            registry.emplace<KeyControl>(entity, 'w');
-            registry.emplace<DeltaTime>(entity, 100U);
-            registry.emplace<SnakeBoundary2D>(entity, 2, 2);
+            registry.emplace<Position>(entity, 3.5f, 0.5f);
+            registry.emplace<Velocity>(entity, 0.0f, 0.0f);
+            registry.emplace<SnakePartHead>(entity, 10.0f, 1.0f); // 10 /s speed
+        }
+        std::vector<entt::entity> parts;
+        for (int i = 2; i >= 0; i--)
+        { // create snake body
+            auto entity = registry.create();
+            registry.emplace<Position>(entity, static_cast<float>(i) + 0.5f, 0.5f);
+            registry.emplace<SnakePart>(entity, 'd');
+            parts.push_back(entity);
+        }
+
+        SnakeGameplaySystem::init(registry);
+        SnakeGameplaySystem::update(registry); // to set the velocity of the snake head based on 'd'
+        for (int i = 0; i < 2; i++)
+        {
+            SystemTranslate2D::update(registry); // 0.1s has passed
+            SnakeGameplaySystem::update(registry);
+        }
+
+        using namespace SnakeGameplaySystem;
+        std::vector<std::vector<MapSlotState>> comp(1, std::vector<MapSlotState>(6, MapSlotState::EMPTY));
+        comp[0][5] = MapSlotState::SNAKE_HEAD;
+        comp[0][4] = comp[0][3] = comp[0][2] = MapSlotState::SNAKE_BODY;
+        EXPECT_TRUE(SnakeGameplaySystem::get_map(registry) == comp);
+
+        // Same entities, the old tail and the one behind it now lead.
+        auto snakePartView = registry.view<SnakePart>();
+        EXPECT_EQ(snakePartView.size(), parts.size());
+        for (auto entity : parts)
+            EXPECT_TRUE(registry.valid(entity) && snakePartView.contains(entity));
+        EXPECT_FLOAT_EQ(registry.get<Position>(parts[1]).x, 4.5f);
+        EXPECT_FLOAT_EQ(registry.get<Position>(parts[2]).x, 3.5f);
+        EXPECT_FLOAT_EQ(registry.get<Position>(parts[0]).x, 2.5f);
+    }
+
+    // init() reserves for a snake filling the board, and a restart on the same registry keeps it.
+    TEST(SnakeGameplaySystemTest, RestartKeepsStorage)
+    {
+        entt::registry registry;
+        size_t partCapacity = 0U, positionCapacity = 0U;
+        for (int game = 0; game < 2; game++)
+        {
+            registry.clear();
+            Resource::set<KeyControl>(registry, 'd');
+            Resource::set<DeltaTime>(registry, 100U);
+            Resource::set<SnakeBoundary2D>(registry, 6, 1);
+            { // create snake head
+                auto entity = registry.create();
+                registry.emplace<Position>(entity, 0.5f, 0.5f);
+                registry.emplace<Velocity>(entity, 0.0f, 0.0f);
+                registry.emplace<SnakePartHead>(entity, 10.0f, 1.0f); // 10 /s speed
+            }
+            { // create apple
+                auto entity = registry.create();
+                registry.emplace<Position>(entity, 1.5f, 0.5f);
+                registry.emplace<SnakeApple>(entity);
+            }
+            SnakeGameplaySystem::init(registry);
+            if (game == 0)
+            {
+                partCapacity = registry.storage<SnakePart>().capacity();
+                positionCapacity = registry.storage<Position>().capacity();
+                EXPECT_GE(partCapacity, 6U);
+                EXPECT_GE(positionCapacity, 8U);
+            }
+
+            SnakeGameplaySystem::update(registry); // to set the velocity of the snake head based on 'd'
+            for (int i = 0; i < 4 && !SnakeGameplaySystem::is_game_failure(registry); i++)
+            {
+                SystemTranslate2D::update(registry); // 0.1s has passed
+                SnakeGameplaySystem::update(registry);
+            }
+            EXPECT_GE(SnakeGameplaySystem::get_score(registry), 1U);
+            EXPECT_EQ(registry.storage<SnakePart>().capacity(), partCapacity);
+            EXPECT_EQ(registry.storage<Position>().capacity(), positionCapacity);
+        }
+    }
+
+    // The scene the game and the tools start from; spawning it again starts over.
+    TEST(SnakeGameplaySystemTest, SpawnScene)
+    {
+        using namespace SnakeGameplaySystem;
+        entt::registry registry;
+        for (int game = 0; game < 2; game++)
+        {
+            const auto head = SnakeGameplaySystem::spawn_scene(registry, 5, 3, 7U, 100U, 10.0f, 2.0f);
+            SnakeGameplaySystem::init(registry);
+            EXPECT_EQ(registry.view<Position>().size(), 2U);
+            EXPECT_EQ(Resource::get<RandomState>(registry).state, 7U);
+            EXPECT_EQ(registry.get<SnakePartHead>(head).speedUpFactor, 2.0f);
+            const auto &board = SnakeGameplaySystem::get_board(registry);
+            EXPECT_EQ(board.get(board.to_index(2, 1)), MapSlotState::APPLE);
+            EXPECT_EQ(board.get(board.to_index(2, 2)), MapSlotState::SNAKE_HEAD);
+
+            SnakeGameplaySystem::update(registry); // heading right
+            SystemTranslate2D::update(registry);
+            SnakeGameplaySystem::update(registry);
+            EXPECT_EQ(board.get(board.to_index(3, 2)), MapSlotState::SNAKE_HEAD);
+        }
+    }
+
+    TEST(SnakeGameplaySystemTest, StatusFromLastTick)
+    {
+        entt::registry registry;
+        for (int game = 0; game < 2; game++)
+        {
+            registry.clear();
+            Resource::set<KeyControl>(registry, 'd');
+            Resource::set<DeltaTime>(registry, 100U);
+            Resource::set<SnakeBoundary2D>(registry, 2, 1);
+            { // create snake head, one slot from the right edge
+                auto entity = registry.create();
+                registry.emplace<Position>(entity, 1.5f, 0.5f);
+                registry.emplace<Velocity>(entity, 0.0f, 0.0f);
+                registry.emplace<SnakePartHead>(entity, 10.0f, 1.0f); // 10 /s speed
+            }
+            { // create apple
+                auto entity = registry.create();
+                registry.emplace<Position>(entity, 0.5f, 0.5f);
+                registry.emplace<SnakeApple>(entity);
+            }
+            SnakeGameplaySystem::init(registry);
+            EXPECT_EQ(SnakeGameplaySystem::get_status(registry), SnakeGameplaySystem::GameStatus::PLAYING);
+
+            SnakeGameplaySystem::update(registry); // to set the velocity of the snake head based on 'd'
+            SystemTranslate2D::update(registry);   // head leaves the board
+            EXPECT_TRUE(SnakeGameplaySystem::is_game_failure(registry));
+            EXPECT_EQ(SnakeGameplaySystem::get_status(registry), SnakeGameplaySystem::GameStatus::PLAYING);
+            SnakeGameplaySystem::update(registry);
+            EXPECT_EQ(SnakeGameplaySystem::get_status(registry), SnakeGameplaySystem::GameStatus::LOST);
+        }
+    }
+
+    TEST(SnakeGameplaySystemTest, TrailingDiagonallyWithoutApple)
+    {
+        entt::registry registry;
+        { // game state resources; 2x2 map
+            Resource::set<KeyControl>(registry, 'w');
+            Resource::set<DeltaTime>(registry, 100U);
+            Resource::set<SnakeBoundary2D>(registry, 2, 2);
         }
         { // create snake head
             auto entity = registry.create();
@@ -94,11 +241,10 @@ namespace
     TEST(SnakeGameplaySystemTest, TrailingOrthogonallyWithApple)
     {
         entt::registry registry;
-        { // create game state entity; 4x1 map
-            auto entity = registry.create();
-            registry.emplace<KeyControl>(entity, 'd');
-            registry.emplace<DeltaTime>(entity, 100U);
-            registry.emplace<SnakeBoundary2D>(entity, 4, 1);
+        { // game state resources; 4x1 map
+            Resource::set<KeyControl>(registry, 'd');
+            Resource::set<DeltaTime>(registry, 100U);
+            Resource::set<SnakeBoundary2D>(registry, 4, 1);
         }
         { // create apple
             auto entity = registry.create();
@@ -143,14 +289,59 @@ namespace
         EXPECT_TRUE(SnakeGameplaySystem::get_map(registry) == comp);
     }
 
-    TEST(SnakeGameplaySystemTest, TrailingDiagonallyWithApple)
+    // iterate() only records the part it grows; the board shows it at once, the registry once the CommandBuffer is applied.
+    TEST(SnakeGameplaySystemTest, GrowthWaitsForCommandBuffer)
     {
         entt::registry registry;
-        { // create game state entity; 2x2 map
+        { // game state resources; 4x1 map
+            Resource::set<KeyControl>(registry, 'd');
+            Resource::set<DeltaTime>(registry, 100U);
+            Resource::set<SnakeBoundary2D>(registry, 4, 1);
+        }
+        { // create apple
+            auto entity = registry.create();
+            registry.emplace<Position>(entity, 2.5f, 0.5f);
+            registry.emplace<SnakeApple>(entity);
+        }
+        { // create snake body
             auto entity = registry.create();
-            registry.emplace<KeyControl>(entity, 'w');
-            registry.emplace<DeltaTime>(entity, 100U);
-            registry.emplace<SnakeBoundary2D>(entity, 2, 2);
+            registry.emplace<Position>(entity, 0.5f, 0.5f);
+            registry.emplace<SnakePart>(entity, 'd');
+        }
+        { // create snake head
+            auto entity = registry.create();
+            registry.emplace<Position>(entity, 1.5f, 0.5f);
+            registry.emplace<Velocity>(entity, 0.0f, 0.0f);
+            registry.emplace<SnakePartHead>(entity, 10.0f, 1.0f); // 10 /s speed
+        }
+
+        SnakeGameplaySystem::init(registry);
+        SnakeGameplaySystem::update(registry); // to set the velocity of the snake head based on 'd'
+        SystemTranslate2D::update(registry);   // 0.1s has passed
+        SnakeGameplaySystem::iterate(registry);
+
+        // x x $ @
+        using namespace SnakeGameplaySystem;
+        std::vector<std::vector<MapSlotState>> comp(1, std::vector<MapSlotState>(4, MapSlotState::EMPTY));
+        comp[0][2] = MapSlotState::SNAKE_HEAD;
+        comp[0][1] = MapSlotState::SNAKE_BODY;
+        comp[0][0] = MapSlotState::SNAKE_BODY;
+        comp[0][3] = MapSlotState::APPLE;
+        EXPECT_TRUE(SnakeGameplaySystem::get_map(registry) == comp);
+        EXPECT_EQ(SnakeGameplaySystem::get_score(registry), 1UL);
+
+        CommandBuffer::iterate(registry);
+        EXPECT_TRUE(SnakeGameplaySystem::get_map(registry) == comp);
+        EXPECT_EQ(SnakeGameplaySystem::get_score(registry), 2UL);
+    }
+
+    TEST(SnakeGameplaySystemTest, TrailingDiagonallyWithApple)
+    {
+        entt::registry registry;
+        { // game state resources; 2x2 map
+            Resource::set<KeyControl>(registry, 'w');
+            Resource::set<DeltaTime>(registry, 100U);
+            Resource::set<SnakeBoundary2D>(registry, 2, 2);
         }
         { // create apple
             auto entity = registry.create();
@@ -194,11 +385,10 @@ namespace
     TEST(SnakeGameplaySystemTest, HeadOnlyEatApple)
     {
         entt::registry registry;
-        { // create game state entity; 3x1 map
-            auto entity = registry.create();
-            registry.emplace<KeyControl>(entity, 'd');
-            registry.emplace<DeltaTime>(entity, 100U);
-            registry.emplace<SnakeBoundary2D>(entity, 3, 1);
+        { // game state resources; 3x1 map
+            Resource::set<KeyControl>(registry, 'd');
+            Resource::set<DeltaTime>(registry, 100U);
+            Resource::set<SnakeBoundary2D>(registry, 3, 1);
         }
         { // create apple
             auto entity = registry.create();
@@ -236,11 +426,10 @@ namespace
     TEST(SnakeGameplaySystemTest, TailMoveOutOfWayBeforeHead)
     {
         entt::registry registry;
-        { // create game state entity; 3x3 map
-            auto entity = registry.create();
-            registry.emplace<KeyControl>(entity, 'w');
-            registry.emplace<DeltaTime>(entity, 100U);
-            registry.emplace<SnakeBoundary2D>(entity, 3, 3);
+        { // game state resources; 3x3 map
+            Resource::set<KeyControl>(registry, 'w');
+            Resource::set<DeltaTime>(registry, 100U);
+            Resource::set<SnakeBoundary2D>(registry, 3, 3);
         }
         { // create snake head
             auto entity = registry.create();
@@ -0,0 +1,336 @@
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include <component/position.hpp>
+#include <component/delta_time.hpp>
+#include <component/snake_part.hpp>
+#include <component/snake_part_head.hpp>
+#include <component/snake_boundary_2d.hpp>
+#include <component/snake_apple.hpp>
+#include <system/translate_2d.hpp>
+#include <system/snake_gameplay_system.hpp>
+
+namespace
+{
+    using namespace SnakeGameplaySystem;
+
+    // 3-by-3 array. [0][1] is top-middle, [2][0] is bottom-left.
+    static_assert(FixedGrid<3, 3>::to_index(1, 0) == 1);
+    static_assert(FixedGrid<3, 3>::to_index(0, 2) == 6);
+    static_assert(FixedGrid<3, 3>::get_pos_from_index(0, 2).x == 0.5f);
+    static_assert(FixedGrid<3, 3>::get_pos_from_index(0, 2).y == 0.5f);
+    static_assert(sizeof(FixedGrid<20, 20>) <= 7 * 64); // a handful of cache lines
+
+    TEST(SnakeGridTest, FixedIndexFromPositionMatchesUtil)
+    {
+        const float values[] = {-1.5f, -1.0f, -0.5f, 0.0f, 0.1f, 0.5f, 1.0f, 1.9f, 2.0f, 4.99999f, 5.0f, 8.5f, 9.5f};
+        for (const float x : values)
+        {
+            for (const float y : values)
+            {
+                long expectedX, expectedY, gridX, gridY;
+                Util::get_index_from_pos(Position{x, y}, &expectedX, &expectedY, 9L);
+                FixedGrid<9, 9>::get_index_from_pos(Position{x, y}, &gridX, &gridY);
+                EXPECT_EQ(gridX, expectedX);
+                EXPECT_EQ(gridY, expectedY);
+
+                Util::get_index_from_pos(Position{x, y}, &expectedX, &expectedY, 1L);
+                FixedGrid<9, 1>::get_index_from_pos(Position{x, y}, &gridX, &gridY);
+                EXPECT_EQ(gridX, expectedX);
+                EXPECT_EQ(gridY, expectedY);
+            }
+        }
+    }
+
+    TEST(SnakeGridTest, NeighboursMatchBetweenGrids)
+    {
+        DynamicGrid dynamicGrid;
+        dynamicGrid.reset(4, 3);
+        FixedGrid<4, 3> fixedGrid;
+        for (long index = 0; index < fixedGrid.area(); index++)
+        {
+            std::vector<std::pair<Direction, long>> fromDynamic, fromFixed;
+            dynamicGrid.for_each_neighbour(index, [&fromDynamic](const Direction &direction, const long &next)
+                                           { fromDynamic.emplace_back(direction, next); });
+            fixedGrid.for_each_neighbour(index, [&fromFixed](const Direction &direction, const long &next)
+                                         { fromFixed.emplace_back(direction, next); });
+            EXPECT_EQ(fromDynamic, fromFixed);
+        }
+
+        std::vector<Direction> cornerDirections;
+        fixedGrid.for_each_neighbour(FixedGrid<4, 3>::to_index(0, 0), [&cornerDirections](const Direction &direction, const long &)
+                                     { cornerDirections.push_back(direction); });
+        EXPECT_EQ(cornerDirections, (std::vector<Direction>{Direction::DOWN, Direction::RIGHT}));
+
+        long next;
+        EXPECT_FALSE(dynamicGrid.step(0, Direction::NO_DIRECTION, &next));
+        EXPECT_TRUE(dynamicGrid.step(dynamicGrid.to_index(1, 1), Direction::UP, &next));
+        EXPECT_EQ(next, dynamicGrid.to_index(1, 0));
+    }
+
+    TEST(SnakeGridTest, DirectionTables)
+    {
+        EXPECT_EQ(Detail::to_direction('w'), Direction::UP);
+        EXPECT_EQ(Detail::to_direction('a'), Direction::LEFT);
+        EXPECT_EQ(Detail::to_direction('s'), Direction::DOWN);
+        EXPECT_EQ(Detail::to_direction('d'), Direction::RIGHT);
+        EXPECT_EQ(Detail::to_direction('W'), Direction::NO_DIRECTION);
+        EXPECT_EQ(Detail::to_direction('\t'), Direction::NO_DIRECTION);
+        EXPECT_EQ(Detail::to_direction(static_cast<char>(0xFF)), Direction::NO_DIRECTION);
+
+        for (const Direction direction : Detail::DIRECTIONS)
+        {
+            EXPECT_EQ(Detail::to_direction(Detail::DIRECTION_KEY[direction]), direction);
+            EXPECT_EQ(Detail::OPPOSITE_DIRECTION[Detail::OPPOSITE_DIRECTION[direction]], direction);
+            EXPECT_EQ(Detail::DIRECTION_DX[direction] + Detail::DIRECTION_DX[Detail::OPPOSITE_DIRECTION[direction]], 0L);
+            EXPECT_EQ(Detail::DIRECTION_DY[direction] + Detail::DIRECTION_DY[Detail::OPPOSITE_DIRECTION[direction]], 0L);
+            // Rows grow downwards, but Position y grows upwards.
+            EXPECT_EQ(Detail::DIRECTION_POS_DX[direction], static_cast<float>(Detail::DIRECTION_DX[direction]));
+            EXPECT_EQ(Detail::DIRECTION_POS_DY[direction], -static_cast<float>(Detail::DIRECTION_DY[direction]));
+            EXPECT_EQ(Detail::get_travelled_direction(5L, 5L, 5L + Detail::DIRECTION_DX[direction], 5L + Detail::DIRECTION_DY[direction]), direction);
+        }
+        EXPECT_EQ(Detail::get_travelled_direction(5L, 5L, 5L, 5L), Direction::NO_DIRECTION);
+        EXPECT_EQ(Detail::get_travelled_direction(5L, 5L, 0L, 9L), Direction::LEFT); // diagonal jumps
+        EXPECT_EQ(Detail::get_travelled_direction(5L, 5L, 9L, 0L), Direction::UP);
+    }
+
+    TEST(SnakeGridTest, SlotCounts)
+    {
+        FixedGrid<2, 2> grid;
+        grid.reset(2, 2);
+        EXPECT_EQ(grid.get_empty_count(), 4);
+        EXPECT_EQ(grid.get_occupied_count(), 0);
+
+        grid.add(0, MapSlotState::APPLE);
+        grid.add(1, MapSlotState::SNAKE_BODY);
+        grid.add(1, MapSlotState::SNAKE_HEAD);
+        grid.mark(2);
+        EXPECT_EQ(grid.get_empty_count(), 2);
+        EXPECT_EQ(grid.get_occupied_count(), 1);
+        EXPECT_EQ(grid.get(2), MapSlotState::EMPTY);
+
+        grid.remove(1, MapSlotState::SNAKE_BODY | MapSlotState::SNAKE_HEAD);
+        grid.unmark(2);
+        EXPECT_EQ(grid.get_empty_count(), 3);
+        EXPECT_EQ(grid.get_occupied_count(), 0);
+    }
+
+    // Random writes on a board that is not a multiple of the chunk size.
+    TEST(SnakeGridTest, ChunkedMatchesDynamic)
+    {
+        std::mt19937 random(3U);
+        DynamicGrid dynamicGrid;
+        ChunkedGrid chunkedGrid;
+        for (int round = 0; round < 3; round++)
+        {
+            dynamicGrid.reset(150, 70);
+            chunkedGrid.reset(150, 70);
+            EXPECT_EQ(chunkedGrid.get_chunk_count(), 0L);
+            for (int i = 0; i < 2000; i++)
+            {
+                const long index = static_cast<long>(random() % 150U) + 150L * static_cast<long>(random() % (round == 2 ? 10U : 70U));
+                const Uint8 bits = static_cast<Uint8>(1U << (random() % 3U));
+                if (random() % 3U == 0U)
+                {
+                    dynamicGrid.remove(index, bits);
+                    chunkedGrid.remove(index, bits);
+                }
+                else
+                {
+                    dynamicGrid.add(index, bits);
+                    chunkedGrid.add(index, bits);
+                }
+            }
+            ASSERT_EQ(chunkedGrid.get_empty_count(), dynamicGrid.get_empty_count());
+            ASSERT_EQ(chunkedGrid.get_occupied_count(), dynamicGrid.get_occupied_count());
+            for (long index = 0; index < dynamicGrid.area(); index++)
+                ASSERT_EQ(chunkedGrid.get(index), dynamicGrid.get(index));
+            for (long n = -1; n <= dynamicGrid.get_empty_count(); n += 7)
+                ASSERT_EQ(chunkedGrid.get_nth_empty(n), dynamicGrid.get_nth_empty(n));
+        }
+        EXPECT_EQ(chunkedGrid.get_chunk_count(), 3L); // only the top row of chunks was written to last
+
+        ChunkedGrid copy = chunkedGrid;
+        EXPECT_TRUE(copy == chunkedGrid);
+        copy.add(copy.to_index(149, 69), MapSlotState::APPLE);
+        EXPECT_TRUE(copy != chunkedGrid);
+    }
+
+    TEST(SnakeGridTest, ChunkedHugeBoard)
+    {
+        ChunkedGrid grid;
+        grid.reset(10000, 10000);
+        grid.add(grid.to_index(0, 0), MapSlotState::SNAKE_HEAD);
+        grid.add(grid.to_index(9999, 9999), MapSlotState::APPLE);
+        grid.mark(grid.to_index(5000, 5000));
+        EXPECT_EQ(grid.get_chunk_count(), 3L);
+        EXPECT_EQ(grid.get_empty_count(), 10000L * 10000L - 2L);
+        EXPECT_EQ(grid.get_nth_empty(0), 1L);
+        EXPECT_EQ(grid.get_nth_empty(10000L * 10000L - 3L), grid.to_index(9998, 9999));
+        EXPECT_EQ(grid.get_nth_empty(10000L * 10000L - 2L), -1L);
+        grid.unmark(grid.to_index(5000, 5000));
+        grid.reset(10000, 10000);
+        EXPECT_EQ(grid.get_chunk_count(), 0L);
+        EXPECT_EQ(grid.get(grid.to_index(0, 0)), MapSlotState::EMPTY);
+    }
+
+    // Same scenario as SnakeGameplayTest's trailing ones, on a board that would be 100 MB dense.
+    TEST(SnakeGameplaySystemChunkedTest, HugeBoard)
+    {
+        entt::registry registry;
+        {
+            Resource::set<KeyControl>(registry, 'd');
+            Resource::set<DeltaTime>(registry, 100U);
+            Resource::set<SnakeBoundary2D>(registry, 10000, 10000);
+        }
+        {
+            auto entity = registry.create();
+            registry.emplace<Position>(entity, 3.5f, 0.5f);
+            registry.emplace<SnakeApple>(entity);
+        }
+        {
+            auto entity = registry.create();
+            registry.emplace<Position>(entity, 1.5f, 0.5f);
+            registry.emplace<Velocity>(entity, 0.0f, 0.0f);
+            registry.emplace<SnakePartHead>(entity, 10.0f, 1.0f); // 10 /s speed
+        }
+        SnakeGameplaySystem::init(registry);
+        SnakeGameplaySystem::update(registry);
+        for (int i = 0; i < 3; i++)
+        {
+            SystemTranslate2D::update(registry);
+            SnakeGameplaySystem::update(registry);
+        }
+        EXPECT_EQ(SnakeGameplaySystem::get_score(registry), 1UL);
+        EXPECT_FALSE(SnakeGameplaySystem::is_game_failure(registry));
+        const ChunkedGrid &board = SnakeGameplaySystem::get_board(registry);
+        EXPECT_EQ(board.get(board.to_index(4, 9999)), MapSlotState::SNAKE_HEAD);
+        EXPECT_EQ(board.get(board.to_index(3, 9999)), MapSlotState::SNAKE_BODY);
+        EXPECT_EQ(board.get_empty_count(), 10000L * 10000L - 3L); // the apple respawned somewhere
+        EXPECT_LE(board.get_chunk_count(), 3L);
+    }
+
+    // The view matches get_map() at every tick, moves only on resize, and its generation changes with the board.
+    TEST(SnakeGameplaySystemChunkedTest, BoardView)
+    {
+        entt::registry registry;
+        Resource::set<KeyControl>(registry, 'd');
+        Resource::set<DeltaTime>(registry, 100U);
+        Resource::set<SnakeBoundary2D>(registry, 9, 7);
+        auto appleEntity = registry.create();
+        registry.emplace<Position>(appleEntity, 4.5f, 3.5f);
+        registry.emplace<SnakeApple>(appleEntity);
+        auto headEntity = registry.create();
+        registry.emplace<Position>(headEntity, 1.5f, 3.5f);
+        registry.emplace<Velocity>(headEntity, 0.0f, 0.0f);
+        registry.emplace<SnakePartHead>(headEntity, 2.5f, 1.0f);
+        SnakeGameplaySystem::init(registry);
+
+        const BoardView first = SnakeGameplaySystem::get_board_view(registry);
+        EXPECT_EQ(first.width, 9L);
+        EXPECT_EQ(first.height, 7L);
+        EXPECT_EQ(first.stride, 9L);
+        EXPECT_EQ(SnakeGameplaySystem::get_board_view(registry).generation, first.generation);
+
+        SDL_srand(5U);
+        const char keys[] = {'w', 'a', 's', 'd'};
+        std::vector<std::vector<MapSlotState>> previousMap = SnakeGameplaySystem::get_map(registry);
+        Uint64 previousGeneration = first.generation;
+        for (int i = 0; i < 400 && !SnakeGameplaySystem::is_game_failure(registry); i++)
+        {
+            if (i % 6 == 0)
+                Resource::get<KeyControl>(registry).lastMovementKeyDown = keys[SDL_rand(4)];
+            SystemTranslate2D::update(registry);
+            SnakeGameplaySystem::update(registry);
+
+            const BoardView view = SnakeGameplaySystem::get_board_view(registry);
+            const std::vector<std::vector<MapSlotState>> map = SnakeGameplaySystem::get_map(registry);
+            ASSERT_EQ(view.data, first.data);
+            for (long y = 0L; y < view.height; y++)
+            {
+                for (long x = 0L; x < view.width; x++)
+                    ASSERT_EQ(view.data[y * view.stride + x], map[y][x]);
+            }
+            EXPECT_EQ(view.generation != previousGeneration, map != previousMap);
+            previousGeneration = view.generation;
+            previousMap = map;
+        }
+
+        Resource::get<SnakeBoundary2D>(registry) = SnakeBoundary2D{12, 12};
+        const BoardView resized = SnakeGameplaySystem::get_board_view(registry);
+        EXPECT_EQ(resized.width, 12L);
+        EXPECT_NE(resized.generation, previousGeneration);
+    }
+
+    TEST(SnakeGameplaySystemFixedTest, TrailingOrthogonallyWithApple)
+    {
+        entt::registry registry;
+        { // game state resources; 4x1 map
+            Resource::set<KeyControl>(registry, 'd');
+            Resource::set<DeltaTime>(registry, 100U);
+            Resource::set<SnakeBoundary2D>(registry, 4, 1);
+        }
+        { // create apple
+            auto entity = registry.create();
+            registry.emplace<Position>(entity, 2.5f, 0.5f);
+            registry.emplace<SnakeApple>(entity);
+        }
+        { // create snake body
+            auto entity = registry.create();
+            registry.emplace<Position>(entity, 0.5f, 0.5f);
+            registry.emplace<SnakePart>(entity, 'd');
+        }
+        { // create snake head
+            auto entity = registry.create();
+            registry.emplace<Position>(entity, 1.5f, 0.5f);
+            registry.emplace<Velocity>(entity, 0.0f, 0.0f);
+            registry.emplace<SnakePartHead>(entity, 10.0f, 1.0f); // 10 /s speed
+        }
+
+        using Engine = SnakeGameplaySystem::Fixed<4, 1>;
+        Engine::init(registry);
+        Engine::update(registry);            // to set the velocity of the snake head based on 'd'
+        SystemTranslate2D::update(registry); // 0.1s has passed
+        Engine::update(registry);
+
+        // x x $ @
+        FixedGrid<4, 1> comp;
+        comp.reset(4, 1);
+        comp.add(2, MapSlotState::SNAKE_HEAD);
+        comp.add(1, MapSlotState::SNAKE_BODY);
+        comp.add(0, MapSlotState::SNAKE_BODY);
+        comp.add(3, MapSlotState::APPLE);
+
+        EXPECT_TRUE(Engine::get_board(registry) == comp);
+        EXPECT_TRUE(SnakeGameplaySystem::get_map(registry)[0][3] == MapSlotState::APPLE);
+        EXPECT_FALSE(Engine::is_game_success(registry));
+        EXPECT_FALSE(Engine::is_game_failure(registry));
+    }
+
+    TEST(SnakeGameplaySystemFixedTest, GameSuccessAndFailure)
+    {
+        entt::registry registry; // 2x1 map with snake head on left and body on right
+        {
+            Resource::set<KeyControl>(registry, 'a');
+            Resource::set<DeltaTime>(registry, 100U);
+            Resource::set<SnakeBoundary2D>(registry, 2, 1);
+
+            auto entitySnakeHead = registry.create();
+            registry.emplace<Position>(entitySnakeHead, 0.5f, 0.5f);
+            registry.emplace<SnakePartHead>(entitySnakeHead, 10.0f, 1.0f);
+
+            auto entitySnakeBody = registry.create();
+            registry.emplace<Position>(entitySnakeBody, 1.5f, 0.5f);
+            registry.emplace<SnakePart>(entitySnakeBody, 'a');
+        }
+        using Engine = SnakeGameplaySystem::Fixed<2, 1>;
+        EXPECT_TRUE(Engine::is_game_success(registry));
+        EXPECT_FALSE(Engine::is_game_failure(registry));
+
+        registry.patch<Position>(registry.view<SnakePartHead>().front(), [](Position &pos)
+                                 { pos.x = -0.5f; });
+        EXPECT_FALSE(Engine::is_game_success(registry));
+        EXPECT_TRUE(Engine::is_game_failure(registry));
+    }
+} // namespace
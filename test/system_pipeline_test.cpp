@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include <sigslot/signal.hpp>
+
+#include <component/position.hpp>
+#include <component/delta_time.hpp>
+#include <component/key_control.hpp>
+#include <component/snake_apple.hpp>
+#include <component/snake_part_head.hpp>
+#include <component/snake_boundary_2d.hpp>
+#include <system/command_buffer.hpp>
+#include <system/translate_2d.hpp>
+#include <system/snake_gameplay_system.hpp>
+#include <system/system_pipeline.hpp>
+
+namespace
+{
+    void record_a(entt::registry &reg) { reg.ctx().get<std::string>() += 'a'; }
+    void record_b(entt::registry &reg) { reg.ctx().get<std::string>() += 'b'; }
+    void record_c(entt::registry &reg) { reg.ctx().get<std::string>() += 'c'; }
+
+    TEST(SystemPipelineTest, RunsInOrder)
+    {
+        entt::registry reg;
+        reg.ctx().emplace<std::string>();
+        SystemPipeline<record_b, record_a, record_b>::iterate(reg);
+        SystemPipeline<>::iterate(reg);
+        EXPECT_EQ(reg.ctx().get<std::string>(), "bab");
+    }
+
+    TEST(SystemPipelineTest, RuntimeSystems)
+    {
+        using Pipeline = SystemPipeline<record_a, RuntimeSystems::iterate, record_a>;
+        entt::registry reg, other;
+        reg.ctx().emplace<std::string>();
+        other.ctx().emplace<std::string>();
+
+        Pipeline::iterate(reg);
+        EXPECT_EQ(reg.ctx().get<std::string>(), "aa");
+        EXPECT_FALSE(RuntimeSystems::disconnect(reg, record_b));
+
+        EXPECT_TRUE(RuntimeSystems::connect(reg, record_c));
+        EXPECT_TRUE(RuntimeSystems::connect(reg, record_b));
+        EXPECT_FALSE(RuntimeSystems::connect(reg, record_c));
+        Pipeline::iterate(reg);
+        Pipeline::iterate(other);
+        EXPECT_EQ(reg.ctx().get<std::string>(), "aaacba");
+        EXPECT_EQ(other.ctx().get<std::string>(), "aa");
+
+        EXPECT_TRUE(RuntimeSystems::disconnect(reg, record_c));
+        EXPECT_FALSE(RuntimeSystems::disconnect(reg, record_c));
+        Pipeline::iterate(reg);
+        EXPECT_EQ(reg.ctx().get<std::string>(), "aaacbaaba");
+    }
+
+    // A pipeline plays the same game as the signal it replaces.
+    TEST(SystemPipelineTest, MatchesSignal)
+    {
+        entt::registry bySignal, byPipeline;
+        for (entt::registry *registry : {&bySignal, &byPipeline})
+        {
+            Resource::set<KeyControl>(*registry, 'd');
+            Resource::set<DeltaTime>(*registry, 100U);
+            Resource::set<SnakeBoundary2D>(*registry, 10, 10);
+            auto entityApple = registry->create();
+            registry->emplace<Position>(entityApple, 6.5f, 5.5f);
+            registry->emplace<SnakeApple>(entityApple);
+            auto entitySnakeHead = registry->create();
+            registry->emplace<Position>(entitySnakeHead, 2.5f, 5.5f);
+            registry->emplace<Velocity>(entitySnakeHead, 0.0f, 0.0f);
+            registry->emplace<SnakePartHead>(entitySnakeHead, 2.5f, 1.0f);
+        }
+        sigslot::signal<entt::registry &> signal;
+        SystemTranslate2D::init(signal);
+        SnakeGameplaySystem::init(signal, bySignal);
+        SnakeGameplaySystem::init(byPipeline);
+
+        const char keys[] = {'d', 's', 'a', 's', 'd', 'w'};
+        for (int i = 0; i < 120; i++)
+        {
+            for (entt::registry *registry : {&bySignal, &byPipeline})
+                Resource::get<KeyControl>(*registry).lastMovementKeyDown = keys[(i / 16) % 6];
+            SDL_srand(static_cast<Uint64>(i));
+            signal(bySignal);
+            SDL_srand(static_cast<Uint64>(i));
+            SystemPipeline<SystemTranslate2D::iterate, SnakeGameplaySystem::iterate, CommandBuffer::iterate>::iterate(byPipeline);
+            ASSERT_TRUE(SnakeGameplaySystem::get_board(bySignal) == SnakeGameplaySystem::get_board(byPipeline));
+        }
+        EXPECT_GE(SnakeGameplaySystem::get_score(byPipeline), 1UL);
+    }
+} // namespace
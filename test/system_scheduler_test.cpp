@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+
+#include <component/position.hpp>
+#include <component/delta_time.hpp>
+#include <component/key_control.hpp>
+#include <component/snake_apple.hpp>
+#include <component/snake_autopilot.hpp>
+#include <component/snake_part.hpp>
+#include <component/snake_part_head.hpp>
+#include <component/snake_boundary_2d.hpp>
+#include <system/command_buffer.hpp>
+#include <system/translate_2d.hpp>
+#include <system/snake_gameplay_system.hpp>
+#include <system/snake_autopilot_system.hpp>
+#include <system/system_scheduler.hpp>
+
+namespace
+{
+    struct PartCount
+    {
+        unsigned long value;
+    }; // struct PartCount
+
+    struct HeadTravel
+    {
+        float value;
+    }; // struct HeadTravel
+
+    // Telemetry-like systems that only read the game and write their own component.
+    void count_parts(entt::registry &reg)
+    {
+        for (auto &entity : reg.view<PartCount>())
+            reg.get<PartCount>(entity).value = reg.view<SnakePart>().size();
+    }
+    using CountPartsAccess = SystemAccess<Reads<SnakePart>, Writes<PartCount>>;
+
+    void measure_head(entt::registry &reg)
+    {
+        auto headView = reg.view<SnakePartHead, Position>();
+        for (auto &entity : reg.view<HeadTravel>())
+        {
+            const Position &pos = headView.get<Position>(headView.front());
+            reg.get<HeadTravel>(entity).value = pos.x + pos.y;
+        }
+    }
+    using MeasureHeadAccess = SystemAccess<Reads<SnakePartHead, Position>, Writes<HeadTravel>>;
+
+    SystemScheduler create_scheduler()
+    {
+        SystemScheduler scheduler;
+        EXPECT_TRUE(scheduler.add<SystemTranslate2D::Access>(SystemTranslate2D::iterate));
+        EXPECT_TRUE(scheduler.add<SnakeGameplaySystem::Access>(SnakeGameplaySystem::iterate));
+        EXPECT_TRUE(scheduler.add<CommandBuffer::Access>(CommandBuffer::iterate));
+        EXPECT_TRUE(scheduler.add<SnakeAutopilotSystem::Access>(SnakeAutopilotSystem::iterate));
+        EXPECT_TRUE(scheduler.add<CountPartsAccess>(count_parts));
+        EXPECT_TRUE(scheduler.add<MeasureHeadAccess>(measure_head));
+        EXPECT_FALSE(scheduler.add<MeasureHeadAccess>(measure_head));
+        return scheduler;
+    }
+
+    TEST(SystemSchedulerTest, Waves)
+    {
+        SystemScheduler scheduler = create_scheduler();
+        const std::vector<std::vector<long>> expected = {{0L}, {1L}, {2L}, {3L, 4L, 5L}};
+        EXPECT_EQ(scheduler.get_waves(), expected);
+
+        // Nothing in common: one wave. Writers of the same component: one after the other.
+        SystemScheduler independent;
+        independent.add<SystemAccess<Reads<Position>, Writes<PartCount>>>(count_parts);
+        independent.add<SystemAccess<Reads<Position>, Writes<HeadTravel>>>(measure_head);
+        independent.add<SystemAccess<Reads<>, Writes<Position>>>(SystemTranslate2D::iterate);
+        const std::vector<std::vector<long>> expectedIndependent = {{0L, 1L}, {2L}};
+        EXPECT_EQ(independent.get_waves(), expectedIndependent);
+    }
+
+    // Scheduled on a WorkerPool, the game plays out exactly as it does system after system.
+    TEST(SystemSchedulerTest, MatchesSerial)
+    {
+        entt::registry serial, scheduled;
+        WorkerPool workerPool(3U);
+        scheduled.ctx().emplace<WorkerPool *>(&workerPool);
+        for (entt::registry *registry : {&serial, &scheduled})
+        {
+            Resource::set<KeyControl>(*registry, 'd');
+            Resource::set<DeltaTime>(*registry, 100U);
+            Resource::set<SnakeBoundary2D>(*registry, 8, 8);
+            auto entity = registry->create();
+            registry->emplace<PartCount>(entity, 0UL);
+            registry->emplace<HeadTravel>(entity, 0.0f);
+
+            auto entityApple = registry->create();
+            registry->emplace<Position>(entityApple, 4.5f, 4.5f);
+            registry->emplace<SnakeApple>(entityApple);
+
+            auto entitySnakeHead = registry->create();
+            registry->emplace<Position>(entitySnakeHead, 1.5f, 1.5f);
+            registry->emplace<Velocity>(entitySnakeHead, 0.0f, 0.0f);
+            registry->emplace<SnakePartHead>(entitySnakeHead, 2.5f, 1.0f);
+            registry->emplace<SnakeAutopilot>(entitySnakeHead);
+            SnakeGameplaySystem::init(*registry);
+        }
+
+        SystemScheduler scheduler = create_scheduler();
+        for (int i = 0; i < 600; i++)
+        {
+            SDL_srand(static_cast<Uint64>(i));
+            SystemTranslate2D::update(serial);
+            SnakeGameplaySystem::update(serial);
+            SnakeAutopilotSystem::update(serial);
+            count_parts(serial);
+            measure_head(serial);
+
+            SDL_srand(static_cast<Uint64>(i));
+            scheduler.iterate(scheduled);
+
+            ASSERT_TRUE(SnakeGameplaySystem::get_board(serial) == SnakeGameplaySystem::get_board(scheduled));
+            const entt::entity gameState = scheduled.view<PartCount>().front();
+            ASSERT_EQ(scheduled.get<PartCount>(gameState).value, SnakeGameplaySystem::get_score(scheduled));
+            ASSERT_EQ(scheduled.get<HeadTravel>(gameState).value, serial.get<HeadTravel>(serial.view<HeadTravel>().front()).value);
+        }
+        EXPECT_GE(SnakeGameplaySystem::get_score(scheduled), 5UL);
+    }
+} // namespace
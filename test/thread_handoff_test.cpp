@@ -0,0 +1,102 @@
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <util/spsc_queue.hpp>
+#include <util/triple_buffer.hpp>
+
+namespace
+{
+    TEST(SpscQueueTest, FullAndEmpty)
+    {
+        SpscQueue<int, 4> queue;
+        int value = 0;
+        EXPECT_FALSE(queue.try_pop(value));
+        for (int i = 0; i < 4; i++)
+            EXPECT_TRUE(queue.try_push(i));
+        EXPECT_FALSE(queue.try_push(4));
+
+        for (int i = 0; i < 4; i++)
+        {
+            EXPECT_TRUE(queue.try_pop(value));
+            EXPECT_EQ(value, i);
+        }
+        EXPECT_FALSE(queue.try_pop(value));
+    }
+
+    TEST(SpscQueueTest, KeepsOrderAcrossThreads)
+    {
+        static constexpr int COUNT = 100000;
+        SpscQueue<int, 64> queue;
+        std::thread producer([&queue]
+                             {
+                                 for (int i = 0; i < COUNT; i++)
+                                 {
+                                     while (!queue.try_push(i))
+                                         std::this_thread::yield();
+                                 } });
+
+        int expected = 0;
+        while (expected < COUNT)
+        {
+            int value;
+            if (!queue.try_pop(value))
+                continue;
+            ASSERT_EQ(value, expected);
+            expected++;
+        }
+        producer.join();
+    }
+
+    TEST(TripleBufferTest, ReadsLatest)
+    {
+        TripleBuffer<int> buffer;
+        EXPECT_FALSE(buffer.update());
+
+        buffer.get_write_buffer() = 1;
+        buffer.publish();
+        buffer.get_write_buffer() = 2;
+        buffer.publish();
+        EXPECT_TRUE(buffer.update());
+        EXPECT_EQ(buffer.read(), 2);
+        EXPECT_FALSE(buffer.update());
+        EXPECT_EQ(buffer.read(), 2);
+
+        buffer.get_write_buffer() = 3;
+        buffer.publish();
+        EXPECT_TRUE(buffer.update());
+        EXPECT_EQ(buffer.read(), 3);
+    }
+
+    TEST(TripleBufferTest, NoTornValuesAcrossThreads)
+    {
+        struct Pair
+        {
+            long a;
+            long b;
+        }; // struct Pair
+        static constexpr long COUNT = 100000L;
+        TripleBuffer<Pair> buffer;
+        std::thread writer([&buffer]
+                           {
+                               for (long i = 1L; i <= COUNT; i++)
+                               {
+                                   Pair &pair = buffer.get_write_buffer();
+                                   pair.a = i;
+                                   pair.b = -i;
+                                   buffer.publish();
+                               } });
+
+        long last = 0L;
+        while (last < COUNT)
+        {
+            if (!buffer.update())
+                continue;
+            const Pair &pair = buffer.read();
+            ASSERT_EQ(pair.b, -pair.a);
+            ASSERT_GT(pair.a, last);
+            last = pair.a;
+        }
+        writer.join();
+    }
+} // namespace
@@ -0,0 +1,175 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include <gtest/gtest.h>
+
+#include <component/delta_time.hpp>
+#include <component/key_control.hpp>
+#include <component/position.hpp>
+#include <component/snake_apple.hpp>
+#include <component/snake_boundary_2d.hpp>
+#include <component/snake_part.hpp>
+#include <component/snake_part_head.hpp>
+#include <component/velocity.hpp>
+#include <system/command_buffer.hpp>
+#include <system/resource.hpp>
+#include <system/translate_2d.hpp>
+#include <system/snake_gameplay_system.hpp>
+#include <system/system_pipeline.hpp>
+
+// Every test in main_test goes through these, but they only count between
+// start() and stop(). Counting covers all threads.
+namespace AllocationCounter
+{
+    std::atomic<bool> isCounting{false};
+    std::atomic<long> count{0L};
+
+    void start()
+    {
+        count.store(0L);
+        isCounting.store(true);
+    }
+    long stop()
+    {
+        isCounting.store(false);
+        return count.load();
+    }
+} // namespace AllocationCounter
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete" // new below is malloc() too
+#endif
+
+void *operator new(std::size_t size)
+{
+    if (AllocationCounter::isCounting.load(std::memory_order_relaxed))
+        AllocationCounter::count.fetch_add(1L, std::memory_order_relaxed);
+    if (void *pointer = std::malloc(size > 0U ? size : 1U))
+        return pointer;
+    throw std::bad_alloc();
+}
+void operator delete(void *pointer) noexcept { std::free(pointer); }
+void operator delete(void *pointer, std::size_t) noexcept { std::free(pointer); }
+
+namespace
+{
+    // Snake of four parts heading right along the middle row, away from the apple,
+    // so the ticks measured only move it.
+    void init_scene(entt::registry &registry)
+    {
+        Resource::set<KeyControl>(registry, 'd');
+        Resource::set<DeltaTime>(registry, 100U);
+        Resource::set<SnakeBoundary2D>(registry, 20, 20);
+        { // create snake head
+            auto entity = registry.create();
+            registry.emplace<Position>(entity, 5.5f, 10.5f);
+            registry.emplace<Velocity>(entity, 0.0f, 0.0f);
+            registry.emplace<SnakePartHead>(entity, 10.0f, 1.0f); // one slot per tick
+        }
+        for (int i = 4; i >= 1; i--)
+        { // create snake body
+            auto entity = registry.create();
+            registry.emplace<Position>(entity, static_cast<float>(i) + 0.5f, 10.5f);
+            registry.emplace<SnakePart>(entity, 'd');
+        }
+        { // create apple
+            auto entity = registry.create();
+            registry.emplace<Position>(entity, 0.5f, 0.5f);
+            registry.emplace<SnakeApple>(entity);
+        }
+    }
+
+    template <typename Engine>
+    long count_steady_state_allocations()
+    {
+        using Pipeline = SystemPipeline<SystemTranslate2D::iterate, Engine::iterate, CommandBuffer::iterate>;
+        entt::registry registry;
+        init_scene(registry);
+        Engine::init(registry);
+        for (int i = 0; i < 2; i++) // warm up: velocity is set, the first neck is taken
+        {
+            Pipeline::iterate(registry);
+            Engine::get_board_view(registry);
+        }
+
+        const unsigned long score = SnakeGameplaySystem::get_score(registry);
+        AllocationCounter::start();
+        for (int i = 0; i < 8; i++)
+        {
+            Pipeline::iterate(registry);
+            Engine::get_board_view(registry);
+            Engine::get_status(registry);
+        }
+        const long count = AllocationCounter::stop();
+
+        EXPECT_EQ(SnakeGameplaySystem::get_score(registry), score);
+        EXPECT_EQ(Engine::get_status(registry), SnakeGameplaySystem::GameStatus::PLAYING);
+        return count;
+    }
+
+    // Snake heading right along the bottom row of a long board, with the apple put in its
+    // way every tick, so that it grows a part a tick, past the spare parts init() makes.
+    constexpr int GROWTH_BOARD_WIDTH = 100;
+    constexpr int GROWTH_BOARD_HEIGHT = 3;
+    template <typename Engine>
+    unsigned long play_growing_game(entt::registry &registry)
+    {
+        using Pipeline = SystemPipeline<SystemTranslate2D::iterate, Engine::iterate, CommandBuffer::iterate>;
+        const entt::entity head = SnakeGameplaySystem::spawn_scene(registry, GROWTH_BOARD_WIDTH, GROWTH_BOARD_HEIGHT, 1U, 100U, 10.0f, 1.0f);
+        Engine::init(registry);
+        for (int i = 0; i < GROWTH_BOARD_WIDTH - 8; i++)
+        {
+            const Position headPos = registry.get<Position>(head);
+            registry.replace<Position>(registry.view<SnakeApple>().front(), static_cast<float>(static_cast<int>(headPos.x)) + 1.5f, headPos.y);
+            Pipeline::iterate(registry);
+            Engine::get_board_view(registry);
+        }
+        EXPECT_EQ(Engine::get_status(registry), SnakeGameplaySystem::GameStatus::PLAYING);
+        return SnakeGameplaySystem::get_score(registry);
+    }
+
+    // The first game on a registry takes what every later one needs: restarting, refilling the
+    // spare parts, growing through them and the CommandBuffer, and tracking it all allocate nothing.
+    template <typename Engine>
+    long count_second_game_allocations()
+    {
+        entt::registry registry;
+        const unsigned long score = play_growing_game<Engine>(registry);
+        EXPECT_GT(score, static_cast<unsigned long>(Engine::SPARE_PART_BATCH));
+
+        AllocationCounter::start();
+        const unsigned long secondScore = play_growing_game<Engine>(registry);
+        const long count = AllocationCounter::stop();
+
+        EXPECT_EQ(secondScore, score);
+        return count;
+    }
+
+    TEST(TickAllocationTest, FixedBoard)
+    {
+        using Engine = SnakeGameplaySystem::Fixed<20, 20>;
+        EXPECT_EQ(count_steady_state_allocations<Engine>(), 0L);
+    }
+
+    TEST(TickAllocationTest, ChunkedBoard)
+    {
+        using Engine = SnakeGameplaySystem::Detail::Engine<SnakeGameplaySystem::ChunkedGrid>; // what SnakeGameplaySystem::iterate() runs
+        EXPECT_EQ(count_steady_state_allocations<Engine>(), 0L);
+    }
+
+    TEST(TickAllocationTest, SecondGameWithGrowth)
+    {
+        using FixedEngine = SnakeGameplaySystem::Fixed<GROWTH_BOARD_WIDTH, GROWTH_BOARD_HEIGHT>;
+        using ChunkedEngine = SnakeGameplaySystem::Detail::Engine<SnakeGameplaySystem::ChunkedGrid>;
+        EXPECT_EQ(count_second_game_allocations<FixedEngine>(), 0L);
+        EXPECT_EQ(count_second_game_allocations<ChunkedEngine>(), 0L);
+    }
+
+    TEST(TickAllocationTest, CounterSeesAllocations)
+    {
+        AllocationCounter::start();
+        ::operator delete(::operator new(16U));
+        EXPECT_EQ(AllocationCounter::stop(), 1L);
+    }
+} // namespace
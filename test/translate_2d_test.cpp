@@ -1,3 +1,5 @@
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include <component/position.hpp>
@@ -13,7 +15,7 @@ namespace
         auto entity = reg.create();
         reg.emplace<Position>(entity, 0.0f, 0.0f);
         reg.emplace<Velocity>(entity, 0.0f, 0.0f);
-        reg.emplace<DeltaTime>(reg.create(), 100U);
+        Resource::set<DeltaTime>(reg, 100U);
 
         SystemTranslate2D::iterate(reg);
 
@@ -37,7 +39,7 @@ namespace
         auto entity = reg.create();
         reg.emplace<Position>(entity, 0.0f, 0.0f);
         reg.emplace<Velocity>(entity, 1.23f, 2.34f);
-        reg.emplace<DeltaTime>(reg.create(), 100U);
+        Resource::set<DeltaTime>(reg, 100U);
 
         SystemTranslate2D::iterate(reg);
 
@@ -69,7 +71,7 @@ namespace
         auto entity = reg.create();
         reg.emplace<Position>(entity, 0.0f, 0.0f);
         reg.emplace<Velocity>(entity, -1.23f, -2.34f);
-        reg.emplace<DeltaTime>(reg.create(), 100U);
+        Resource::set<DeltaTime>(reg, 100U);
 
         SystemTranslate2D::iterate(reg);
 
@@ -111,6 +113,44 @@ namespace
         EXPECT_FLOAT_EQ(pos.y, 0.0f);
     }
 
+    TEST(Translate2DSystemTest, ManyEntities)
+    {
+        entt::registry reg;
+        Resource::set<DeltaTime>(reg, 16U);
+        std::vector<entt::entity> entities;
+        for (int i = 0; i < 2500; i++)
+        {
+            auto entity = reg.create();
+            reg.emplace<Position>(entity, 0.1f * static_cast<float>(i), -0.2f * static_cast<float>(i));
+            if (i % 7 != 3) // some entities stand still without a velocity
+                reg.emplace<Velocity>(entity, 0.37f * static_cast<float>(i % 13), -1.9f + 0.01f * static_cast<float>(i));
+            entities.push_back(entity);
+        }
+
+        std::vector<Position> expected;
+        for (auto entity : entities)
+            expected.push_back(reg.get<Position>(entity));
+        for (int tick = 0; tick < 3; tick++)
+        {
+            SystemTranslate2D::iterate(reg);
+            for (size_t i = 0U; i < entities.size(); i++)
+            {
+                if (const Velocity *vel = reg.try_get<Velocity>(entities[i]); vel != nullptr)
+                {
+                    expected[i].x += vel->x * (16U / 1000.0f);
+                    expected[i].y += vel->y * (16U / 1000.0f);
+                }
+            }
+        }
+
+        for (size_t i = 0U; i < entities.size(); i++)
+        {
+            const Position &pos = reg.get<Position>(entities[i]);
+            EXPECT_EQ(pos.x, expected[i].x);
+            EXPECT_EQ(pos.y, expected[i].y);
+        }
+    }
+
     TEST(Translate2DSystemTest, MultipleInit)
     {
         sigslot::signal<entt::registry &> gameplaySceneSignal;
@@ -0,0 +1,179 @@
+#include "snake_batch_env.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <SDL3/SDL_stdinc.h>
+#include <entt/entt.hpp>
+
+#include <component/key_control.hpp>
+#include <component/position.hpp>
+#include <component/random_state.hpp>
+#include <component/snake_part_head.hpp>
+
+#include <system/command_buffer.hpp>
+#include <system/resource.hpp>
+#include <system/translate_2d.hpp>
+#include <system/snake_gameplay_system.hpp>
+#include <system/system_pipeline.hpp>
+#include <util/worker_pool.hpp>
+
+namespace
+{
+    using GameplayPipeline = SystemPipeline<SystemTranslate2D::iterate, SnakeGameplaySystem::iterate, CommandBuffer::iterate>;
+
+    constexpr float SPEED = 2.0f;
+    constexpr Uint64 TICK_PERIOD_MS = 250U; // half a slot per tick, the most the gameplay system allows
+    constexpr int MAX_TICKS_PER_STEP = 4;
+
+    struct Game
+    {
+        entt::registry reg;
+        Uint64 randomState;
+        long stepsSinceApple;
+        unsigned long score;
+    }; // struct Game
+
+    // The registry keeps its storage across games, and the random state carries on from the last one.
+    void init_scene(Game &game, const int &width, const int &height)
+    {
+        SnakeGameplaySystem::spawn_scene(game.reg, width, height, game.randomState, TICK_PERIOD_MS, SPEED, 1.0f);
+        SnakeGameplaySystem::init(game.reg);
+        game.stepsSinceApple = 0L;
+        game.score = 0UL;
+    }
+
+    void write_observation(entt::registry &reg, Uint8 *observation)
+    {
+        const SnakeGameplaySystem::BoardView board = SnakeGameplaySystem::get_board_view(reg);
+        std::memcpy(observation, board.data, static_cast<size_t>(board.height * board.stride));
+    }
+
+    void get_head_cell(entt::registry &reg, const int &height, long *x, long *y)
+    {
+        const Position &pos = reg.get<Position>(reg.view<SnakePartHead, Position>().front());
+        *x = SnakeGameplaySystem::Detail::get_column_from_pos(pos.x);
+        *y = SnakeGameplaySystem::Detail::get_row_from_pos(pos.y, height);
+    }
+} // namespace
+
+struct SnakeBatchEnv
+{
+    SnakeBatchEnv(const int &batchSize, const int &width, const int &height, const unsigned &threadCount)
+        : games(static_cast<size_t>(batchSize)), width(width), height(height), workerPool(threadCount - 1U) {}
+
+    std::vector<Game> games;
+    int width;
+    int height;
+    WorkerPool workerPool;
+}; // struct SnakeBatchEnv
+
+namespace
+{
+    // Calls runGame(i) for every game on the worker threads. An exception must not leave
+    // them, nor the C interface: returns false if any game threw.
+    template <typename RunGame>
+    bool run_games(SnakeBatchEnv *env, RunGame &&runGame)
+    {
+        std::atomic<bool> isFailed{false};
+        auto runGames = [&runGame, &isFailed](const long &begin, const long &end)
+        {
+            for (long i = begin; i < end; i++)
+            {
+                try
+                {
+                    runGame(i);
+                }
+                catch (...)
+                {
+                    isFailed = true;
+                }
+            }
+        };
+        env->workerPool.parallel_for(static_cast<long>(env->games.size()), runGames);
+        return !isFailed;
+    }
+} // namespace
+
+SnakeBatchEnv *snake_batch_env_create(int32_t batchSize, int32_t width, int32_t height, uint64_t seed, int32_t threadCount)
+{
+    if (batchSize <= 0 || width < SnakeGameplaySystem::MIN_SCENE_WIDTH || height <= 0)
+        return nullptr;
+    const unsigned threads = threadCount > 0 ? static_cast<unsigned>(threadCount) : std::max(1U, std::thread::hardware_concurrency());
+    try
+    {
+        std::unique_ptr<SnakeBatchEnv> env = std::make_unique<SnakeBatchEnv>(batchSize, width, height, threads);
+        for (size_t i = 0U; i < env->games.size(); i++)
+        {
+            env->games[i].randomState = seed + i;
+            init_scene(env->games[i], width, height);
+        }
+        return env.release();
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+void snake_batch_env_destroy(SnakeBatchEnv *env) { delete env; }
+
+int32_t snake_batch_env_reset(SnakeBatchEnv *env, uint8_t *observations)
+{
+    const long area = static_cast<long>(env->width) * env->height;
+    auto resetGame = [env, &area, observations](const long &i)
+    {
+        Game &game = env->games[i];
+        // A failed reset may have left the registry without its resources.
+        if (const RandomState *randomState = Resource::find<RandomState>(game.reg))
+            game.randomState = randomState->state;
+        init_scene(game, env->width, env->height);
+        write_observation(game.reg, observations + i * area);
+    };
+    return run_games(env, resetGame) ? 0 : -1;
+}
+
+int32_t snake_batch_env_step(SnakeBatchEnv *env, const uint8_t *actions, float *rewards, uint8_t *dones, uint8_t *observations)
+{
+    const long area = static_cast<long>(env->width) * env->height;
+    auto stepGame = [env, &area, actions, rewards, dones, observations](const long &i)
+    {
+        Game &game = env->games[i];
+        entt::registry &reg = game.reg;
+        if (actions[i] < SNAKE_ACTION_NONE)
+            Resource::get<KeyControl>(reg).lastMovementKeyDown = SnakeGameplaySystem::Detail::DIRECTION_KEY[actions[i]];
+
+        // Tick until the head reaches the next slot.
+        long startX, startY, x, y;
+        get_head_cell(reg, env->height, &startX, &startY);
+        bool isFailure = false, isSuccess = false;
+        for (int tick = 0; tick < MAX_TICKS_PER_STEP; tick++)
+        {
+            GameplayPipeline::iterate(reg);
+            isFailure = SnakeGameplaySystem::is_game_failure(reg);
+            isSuccess = !isFailure && SnakeGameplaySystem::is_game_success(reg);
+            get_head_cell(reg, env->height, &x, &y);
+            if (isFailure || isSuccess || x != startX || y != startY)
+                break;
+        }
+
+        // Running into the body removes the part under the head, so the score can drop on failure.
+        const unsigned long score = SnakeGameplaySystem::get_score(reg);
+        const bool isEaten = score > game.score;
+        rewards[i] = (isEaten ? static_cast<float>(score - game.score) : 0.0f) - (isFailure ? 1.0f : 0.0f);
+        game.stepsSinceApple = isEaten ? 0L : game.stepsSinceApple + 1L;
+        game.score = score;
+        dones[i] = isFailure || isSuccess || game.stepsSinceApple >= 2L * area;
+        if (dones[i])
+        {
+            game.randomState = Resource::get<RandomState>(reg).state;
+            init_scene(game, env->width, env->height);
+        }
+        write_observation(reg, observations + i * area);
+    };
+    return run_games(env, stepGame) ? 0 : -1;
+}
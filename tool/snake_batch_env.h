@@ -0,0 +1,72 @@
+#ifndef TOOL_SNAKE_BATCH_ENV_H
+#define TOOL_SNAKE_BATCH_ENV_H
+
+/*
+ * C interface to a batch of independent snake games for training agents.
+ *
+ * Every game starts from SnakeGameplaySystem::spawn_scene(), as in the game, on its
+ * own board of width x height slots. One step moves every head by one slot.
+ * Observations are batchSize x height x width bytes, row 0 at the top, each
+ * byte a MapSlotState (0 empty, 1 snake head, 2 snake body, 4 apple, and
+ * 3 for a head that ran into the body). A game that ends is started again
+ * right away, so the observation written for it is the first one of the next
+ * game, while its done flag reports the end of the previous one.
+ *
+ * Buffers are owned by the caller; steps do not allocate.
+ *
+ * No C++ exception leaves these functions. If memory runs out, create returns
+ * NULL and reset and step return -1; the games are in no known state then,
+ * and the environment can only be reset (which may fail again) or destroyed.
+ */
+
+#include <stdint.h>
+
+#if defined(_WIN32)
+#if defined(SNAKE_BATCH_ENV_BUILD)
+#define SNAKE_BATCH_ENV_API __declspec(dllexport)
+#else
+#define SNAKE_BATCH_ENV_API __declspec(dllimport)
+#endif
+#else
+#define SNAKE_BATCH_ENV_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /* Actions; anything else keeps the current direction. */
+    enum
+    {
+        SNAKE_ACTION_UP = 0,
+        SNAKE_ACTION_LEFT = 1,
+        SNAKE_ACTION_DOWN = 2,
+        SNAKE_ACTION_RIGHT = 3,
+        SNAKE_ACTION_NONE = 4
+    };
+
+    typedef struct SnakeBatchEnv SnakeBatchEnv;
+
+    /*
+     * threadCount 0 uses every core. Returns NULL if a size is not positive, the board is
+     * narrower than 3 slots (the head starts in the third column) or memory ran out.
+     */
+    SNAKE_BATCH_ENV_API SnakeBatchEnv *snake_batch_env_create(int32_t batchSize, int32_t width, int32_t height, uint64_t seed, int32_t threadCount);
+    SNAKE_BATCH_ENV_API void snake_batch_env_destroy(SnakeBatchEnv *env);
+
+    /* Starts every game again and writes their observations. Returns 0, or -1 on failure. */
+    SNAKE_BATCH_ENV_API int32_t snake_batch_env_reset(SnakeBatchEnv *env, uint8_t *observations);
+
+    /*
+     * Applies actions[batchSize] and advances every game by one slot. Rewards are
+     * +1 for eating an apple and -1 for dying. A game is also done once it is won,
+     * or after 2 x width x height steps without eating. Returns 0, or -1 on failure.
+     */
+    SNAKE_BATCH_ENV_API int32_t snake_batch_env_step(SnakeBatchEnv *env, const uint8_t *actions, float *rewards, uint8_t *dones, uint8_t *observations);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TOOL_SNAKE_BATCH_ENV_H */
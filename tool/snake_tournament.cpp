@@ -0,0 +1,290 @@
+// Plays many seeded games per controller policy on every core and reports how
+// each policy does, so policy changes can be compared without watching a window.
+//
+// usage: snake_tournament [--games N] [--width W] [--height H] [--seed S]
+//                         [--threads T] [--stall-ticks M] [--policy NAME]...
+//                         [--cycle-cache DIR]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <SDL3/SDL_stdinc.h>
+#include <entt/entt.hpp>
+
+#include <component/position.hpp>
+#include <component/snake_apple.hpp>
+#include <component/snake_autopilot.hpp>
+
+#include <system/command_buffer.hpp>
+#include <system/resource.hpp>
+#include <system/translate_2d.hpp>
+#include <system/snake_gameplay_system.hpp>
+#include <system/snake_autopilot_system.hpp>
+#include <system/snake_cycle.hpp>
+#include <system/system_pipeline.hpp>
+#include <util/worker_pool.hpp>
+
+namespace
+{
+    using SnakeGameplaySystem::Direction;
+
+    using GameplayPipeline = SystemPipeline<SystemTranslate2D::iterate, SnakeGameplaySystem::iterate, CommandBuffer::iterate>;
+    // The autopilot steers by the snake as it has grown, so the CommandBuffer is applied before it.
+    using AutopilotPipeline = SystemPipeline<SystemTranslate2D::iterate, SnakeGameplaySystem::iterate, CommandBuffer::iterate, SnakeAutopilotSystem::iterate>;
+
+    constexpr float SPEED = 2.0f;
+    constexpr Uint64 TICK_PERIOD_MS = 125U; // a quarter of a slot per tick, like the game
+
+    enum Policy
+    {
+        SCRIPTED,
+        SHORTEST_PATH,
+        CYCLE,
+        RANDOM,
+        POLICY_COUNT
+    };
+    constexpr const char *POLICY_NAME[POLICY_COUNT] = {"scripted", "bfs", "cycle", "random"};
+
+    enum Outcome
+    {
+        WON,
+        LOST,
+        TIMED_OUT
+    };
+
+    struct Settings
+    {
+        long games = 256L;
+        int width = 20;
+        int height = 20;
+        Uint64 seed = 1U;
+        unsigned threads = 0U; // 0 for one per core
+        long stallTicks = 0L;  // ticks without eating before a game times out; 0 for 16 per slot
+        std::vector<Policy> policies;
+        std::string cycleCache;
+    }; // struct Settings
+
+    struct GameResult
+    {
+        unsigned long score;
+        long ticks;
+        Outcome outcome;
+    }; // struct GameResult
+
+    void press(entt::registry &reg, const Direction &direction)
+    {
+        static void (*const KEY_DOWN[])(entt::registry &) = {
+            SnakeGameplaySystem::Control::up_key_down,
+            SnakeGameplaySystem::Control::left_key_down,
+            SnakeGameplaySystem::Control::down_key_down,
+            SnakeGameplaySystem::Control::right_key_down,
+        };
+        if (direction != Direction::NO_DIRECTION)
+            KEY_DOWN[direction](reg);
+    }
+
+    void get_cell(const Position &pos, const long &height, long *x, long *y)
+    {
+        *x = SnakeGameplaySystem::Detail::get_column_from_pos(pos.x);
+        *y = SnakeGameplaySystem::Detail::get_row_from_pos(pos.y, height);
+    }
+
+    // Heads for the apple one axis at a time, avoiding only the slot right in front.
+    Direction decide_scripted(entt::registry &reg, const long &headX, const long &headY)
+    {
+        const auto &board = SnakeGameplaySystem::get_board(reg);
+        long appleX = headX, appleY = headY;
+        auto appleView = reg.view<SnakeApple, Position>();
+        if (!appleView.storage<SnakeApple>()->empty())
+            get_cell(appleView.get<Position>(appleView.front()), board.height(), &appleX, &appleY);
+
+        Direction best = Direction::NO_DIRECTION;
+        long bestDistance = 0L;
+        for (const Direction direction : SnakeGameplaySystem::Detail::DIRECTIONS)
+        {
+            const long x = headX + SnakeGameplaySystem::Detail::DIRECTION_DX[direction];
+            const long y = headY + SnakeGameplaySystem::Detail::DIRECTION_DY[direction];
+            if (!board.is_in_bounds(x, y) || (board.get(board.to_index(x, y)) & SnakeGameplaySystem::Detail::SLOT_OCCUPIED))
+                continue;
+            const long distance = std::labs(appleX - x) + std::labs(appleY - y);
+            if (best == Direction::NO_DIRECTION || distance < bestDistance)
+            {
+                best = direction;
+                bestDistance = distance;
+            }
+        }
+        return best;
+    }
+
+    GameResult play(entt::registry &reg, const Settings &settings, const Policy &policy, const Uint64 &seed)
+    {
+        // The registry keeps its storage across games, so only the first game on it allocates.
+        const entt::entity head = SnakeGameplaySystem::spawn_scene(reg, settings.width, settings.height, seed, TICK_PERIOD_MS, SPEED, 1.0f);
+        if (policy == Policy::SHORTEST_PATH)
+            reg.emplace<SnakeAutopilot>(head, SnakeAutopilot::SHORTEST_PATH);
+        else if (policy == Policy::CYCLE)
+            reg.emplace<SnakeAutopilot>(head, SnakeAutopilot::HAMILTONIAN_CYCLE);
+        SnakeGameplaySystem::init(reg);
+
+        Uint64 policyRandomState = seed ^ 0x9e3779b97f4a7c15U;
+        long previousX = -1L, previousY = -1L;
+        const long area = static_cast<long>(settings.width) * settings.height;
+        const long stallTicks = settings.stallTicks > 0L ? settings.stallTicks : 16L * area;
+        long lastEatenTick = 0L;
+        GameResult result = {0UL, 0L, Outcome::TIMED_OUT};
+        for (; result.ticks - lastEatenTick < stallTicks; result.ticks++)
+        {
+            if (SnakeGameplaySystem::is_game_success(reg))
+            {
+                result.outcome = Outcome::WON;
+                break;
+            }
+            if (SnakeGameplaySystem::is_game_failure(reg))
+            {
+                result.outcome = Outcome::LOST;
+                break;
+            }
+
+            if (policy == Policy::SCRIPTED || policy == Policy::RANDOM)
+            {
+                long x, y;
+                get_cell(reg.get<Position>(head), settings.height, &x, &y);
+                if (x != previousX || y != previousY)
+                {
+                    previousX = x;
+                    previousY = y;
+                    press(reg, policy == Policy::SCRIPTED ? decide_scripted(reg, x, y)
+                                                          : SnakeGameplaySystem::Detail::DIRECTIONS[SDL_rand_r(&policyRandomState, 4)]);
+                }
+            }
+
+            if (policy == Policy::SHORTEST_PATH || policy == Policy::CYCLE)
+                AutopilotPipeline::iterate(reg);
+            else
+                GameplayPipeline::iterate(reg);
+
+            const unsigned long score = SnakeGameplaySystem::get_score(reg);
+            if (score != result.score)
+            {
+                result.score = score;
+                lastEatenTick = result.ticks;
+            }
+        }
+        return result;
+    }
+
+    template <typename T>
+    T get_percentile(const std::vector<T> &sorted, const long &percent)
+    {
+        return sorted[static_cast<size_t>(percent * static_cast<long>(sorted.size() - 1U) / 100L)];
+    }
+
+    void report(const Policy &policy, const std::vector<GameResult> &results, const double &seconds)
+    {
+        std::vector<unsigned long> scores;
+        std::vector<long> lengths;
+        long outcomeCounts[3] = {0L, 0L, 0L};
+        double scoreSum = 0.0, tickSum = 0.0;
+        for (const GameResult &result : results)
+        {
+            scores.push_back(result.score);
+            lengths.push_back(result.ticks);
+            outcomeCounts[result.outcome]++;
+            scoreSum += static_cast<double>(result.score);
+            tickSum += static_cast<double>(result.ticks);
+        }
+        std::sort(scores.begin(), scores.end());
+        std::sort(lengths.begin(), lengths.end());
+        const double gameCount = static_cast<double>(results.size());
+
+        std::cout << std::fixed << std::setprecision(1)
+                  << std::left << std::setw(10) << POLICY_NAME[policy] << std::right
+                  << std::setw(7) << results.size()
+                  << std::setw(8) << 100.0 * outcomeCounts[Outcome::WON] / gameCount
+                  << std::setw(8) << 100.0 * outcomeCounts[Outcome::LOST] / gameCount
+                  << std::setw(8) << 100.0 * outcomeCounts[Outcome::TIMED_OUT] / gameCount
+                  << "   " << scores.front() << '/' << get_percentile(scores, 25L) << '/' << get_percentile(scores, 50L)
+                  << '/' << get_percentile(scores, 75L) << '/' << scores.back()
+                  << std::setw(9) << scoreSum / gameCount
+                  << std::setw(11) << tickSum / gameCount
+                  << std::setw(9) << get_percentile(lengths, 50L)
+                  << std::setw(13) << std::setprecision(0) << tickSum / seconds << std::endl;
+    }
+
+    bool parse(int argc, char **argv, Settings &settings)
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            const std::string option = argv[i];
+            if (i + 1 >= argc)
+                return false;
+            const std::string value = argv[++i];
+            if (option == "--games")
+                settings.games = std::atol(value.c_str());
+            else if (option == "--width")
+                settings.width = std::atoi(value.c_str());
+            else if (option == "--height")
+                settings.height = std::atoi(value.c_str());
+            else if (option == "--seed")
+                settings.seed = std::strtoull(value.c_str(), nullptr, 10);
+            else if (option == "--threads")
+                settings.threads = static_cast<unsigned>(std::atoi(value.c_str()));
+            else if (option == "--stall-ticks")
+                settings.stallTicks = std::atol(value.c_str());
+            else if (option == "--cycle-cache")
+                settings.cycleCache = value;
+            else if (option == "--policy")
+            {
+                const auto found = std::find(std::begin(POLICY_NAME), std::end(POLICY_NAME), value);
+                if (found == std::end(POLICY_NAME))
+                    return false;
+                settings.policies.push_back(static_cast<Policy>(found - std::begin(POLICY_NAME)));
+            }
+            else
+                return false;
+        }
+        if (settings.policies.empty())
+            settings.policies = {Policy::SCRIPTED, Policy::SHORTEST_PATH, Policy::CYCLE, Policy::RANDOM};
+        return settings.games > 0L && settings.width >= SnakeGameplaySystem::MIN_SCENE_WIDTH && settings.height >= 1;
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Settings settings;
+    if (!parse(argc, argv, settings))
+    {
+        std::cerr << "usage: snake_tournament [--games N] [--width W] [--height H] [--seed S] [--threads T]"
+                  << " [--stall-ticks M] [--policy scripted|bfs|cycle|random]... [--cycle-cache DIR]" << std::endl;
+        return 1;
+    }
+    SnakeGameplaySystem::set_cycle_cache_directory(settings.cycleCache);
+
+    WorkerPool workerPool(settings.threads > 0U ? settings.threads - 1U : std::max(1U, std::thread::hardware_concurrency()) - 1U);
+    std::cout << settings.games << " games per policy on a " << settings.width << 'x' << settings.height
+              << " board, " << workerPool.get_thread_count() << " threads, seed " << settings.seed << std::endl;
+    std::cout << "policy      games   won%   lost%  tmout%   score min/p25/med/p75/max  mean"
+              << "  ticks mean   median    ticks/sec" << std::endl;
+
+    std::vector<GameResult> results(static_cast<size_t>(settings.games));
+    for (const Policy policy : settings.policies)
+    {
+        // Game i gets the same seed under every policy, so they all face the same apples at first.
+        const auto start = std::chrono::steady_clock::now();
+        workerPool.parallel_for(settings.games, [&settings, &policy, &results](const long &begin, const long &end)
+                                {
+                                    entt::registry reg;
+                                    for (long i = begin; i < end; i++)
+                                        results[i] = play(reg, settings, policy, settings.seed + static_cast<Uint64>(i));
+                                });
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        report(policy, results, elapsed.count());
+    }
+    return 0;
+}
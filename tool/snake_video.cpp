@@ -0,0 +1,301 @@
+// Plays one seeded bot game without a window and writes a frame per tick as
+// raw RGB24 or Y4M, for highlight videos. The board is drawn by an SDL software
+// renderer onto a surface; converting and writing the frames happens on a
+// writer thread behind a bounded queue, so the ticks only wait when it is full.
+//
+// usage: snake_video [--width W] [--height H] [--seed S] [--policy bfs|cycle]
+//                    [--cell-px P] [--format rgb|y4m] [--output FILE|-]
+//                    [--queue-frames Q] [--max-ticks M]
+//
+// e.g. snake_video --policy cycle --format y4m | ffmpeg -i - highlight.mp4
+
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <SDL3/SDL.h>
+#include <entt/entt.hpp>
+
+#include <component/snake_autopilot.hpp>
+
+#include <system/command_buffer.hpp>
+#include <system/resource.hpp>
+#include <system/translate_2d.hpp>
+#include <system/snake_gameplay_system.hpp>
+#include <system/snake_autopilot_system.hpp>
+#include <system/system_pipeline.hpp>
+
+namespace
+{
+    // The autopilot steers by the snake as it has grown, so the CommandBuffer is applied before it.
+    using AutopilotPipeline = SystemPipeline<SystemTranslate2D::iterate, SnakeGameplaySystem::iterate, CommandBuffer::iterate, SnakeAutopilotSystem::iterate>;
+
+    constexpr float SPEED = 2.0f;
+    constexpr Uint64 TICK_PERIOD_MS = 125U; // a quarter of a slot per tick, like the game
+
+    enum Format
+    {
+        RGB,
+        Y4M,
+    };
+
+    struct Settings
+    {
+        int width = 20;
+        int height = 20;
+        Uint64 seed = 1U;
+        SnakeAutopilot::Policy policy = SnakeAutopilot::SHORTEST_PATH;
+        int cellPx = 16;
+        Format format = Format::Y4M;
+        std::string output = "-";
+        long queueFrames = 64L;
+        long maxTicks = 0L; // 0 for 16 per slot
+    }; // struct Settings
+
+    // Frames of XRGB8888 pixels, row after row without padding. Buffers go back
+    // to a free list once written, so after the queue fills up nothing is allocated.
+    class FrameQueue
+    {
+    public:
+        explicit FrameQueue(const size_t &capacity) : capacity(capacity) {}
+
+        std::vector<Uint32> get_free_frame()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (freeFrames.empty())
+                return {};
+            std::vector<Uint32> frame = std::move(freeFrames.back());
+            freeFrames.pop_back();
+            return frame;
+        }
+        // Waits while the queue is full.
+        void push(std::vector<Uint32> &&frame)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            notFull.wait(lock, [this]
+                         { return frames.size() < capacity; });
+            frames.push_back(std::move(frame));
+            notEmpty.notify_one();
+        }
+        // False once the queue is closed and empty.
+        bool pop(std::vector<Uint32> &frame)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            notEmpty.wait(lock, [this]
+                          { return !frames.empty() || isClosed; });
+            if (frames.empty())
+                return false;
+            frame = std::move(frames.front());
+            frames.pop_front();
+            notFull.notify_one();
+            return true;
+        }
+        void recycle(std::vector<Uint32> &&frame)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            freeFrames.push_back(std::move(frame));
+        }
+        void close()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            isClosed = true;
+            notEmpty.notify_all();
+        }
+
+    private:
+        const size_t capacity;
+        std::mutex mutex;
+        std::condition_variable notFull;
+        std::condition_variable notEmpty;
+        std::deque<std::vector<Uint32>> frames;
+        std::vector<std::vector<Uint32>> freeFrames;
+        bool isClosed = false;
+    }; // class FrameQueue
+
+    // Converts and writes frames until the queue is closed. Y4M is 4:4:4 with BT.601 studio range.
+    void write_frames(FrameQueue &queue, std::FILE *file, const Format &format, const int &width, const int &height, bool *isFailed)
+    {
+        const size_t pixelCount = static_cast<size_t>(width) * static_cast<size_t>(height);
+        std::vector<Uint8> bytes(pixelCount * 3U);
+        std::vector<Uint32> frame;
+        while (queue.pop(frame))
+        {
+            if (format == Format::RGB)
+            {
+                for (size_t i = 0U; i < pixelCount; i++)
+                {
+                    bytes[3U * i] = static_cast<Uint8>(frame[i] >> 16);
+                    bytes[3U * i + 1U] = static_cast<Uint8>(frame[i] >> 8);
+                    bytes[3U * i + 2U] = static_cast<Uint8>(frame[i]);
+                }
+            }
+            else
+            {
+                std::fputs("FRAME\n", file);
+                for (size_t i = 0U; i < pixelCount; i++)
+                {
+                    const int r = static_cast<int>((frame[i] >> 16) & 0xFFU);
+                    const int g = static_cast<int>((frame[i] >> 8) & 0xFFU);
+                    const int b = static_cast<int>(frame[i] & 0xFFU);
+                    bytes[i] = static_cast<Uint8>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+                    bytes[pixelCount + i] = static_cast<Uint8>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+                    bytes[2U * pixelCount + i] = static_cast<Uint8>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+                }
+            }
+            if (std::fwrite(bytes.data(), 1U, bytes.size(), file) != bytes.size())
+                *isFailed = true;
+            queue.recycle(std::move(frame));
+        }
+    }
+
+    // Fills the occupied slots, one SDL_RenderFillRects() per color.
+    bool render_board(SDL_Renderer *renderer, const SnakeGameplaySystem::BoardView &board, const float &cellPx, std::vector<SDL_FRect> (&rectsBySlot)[8])
+    {
+        for (std::vector<SDL_FRect> &rects : rectsBySlot)
+            rects.clear();
+        for (long i = 0; i < board.height; i++)
+        {
+            for (long j = 0; j < board.width; j++)
+            {
+                const Uint8 slot = board.data[i * board.stride + j] & 0b0111U;
+                if (slot != SnakeGameplaySystem::MapSlotState::EMPTY)
+                    rectsBySlot[slot].push_back(SDL_FRect{static_cast<float>(j) * cellPx, static_cast<float>(i) * cellPx, cellPx, cellPx});
+            }
+        }
+
+        bool isDrawn = SDL_SetRenderDrawColor(renderer, 0U, 0U, 0U, SDL_ALPHA_OPAQUE) && SDL_RenderClear(renderer);
+        for (Uint8 slot = 1U; slot < 8U && isDrawn; slot++)
+        {
+            if (rectsBySlot[slot].empty())
+                continue;
+            const Uint8 r = (slot & SnakeGameplaySystem::MapSlotState::APPLE) ? 255U : 0U;
+            const Uint8 g = (slot & SnakeGameplaySystem::MapSlotState::SNAKE_BODY) ? 255U : 0U;
+            const Uint8 b = (slot & SnakeGameplaySystem::MapSlotState::SNAKE_HEAD) ? 255U : 0U;
+            isDrawn = SDL_SetRenderDrawColor(renderer, r, g, b, SDL_ALPHA_OPAQUE) &&
+                      SDL_RenderFillRects(renderer, rectsBySlot[slot].data(), static_cast<int>(rectsBySlot[slot].size()));
+        }
+        return isDrawn && SDL_FlushRenderer(renderer);
+    }
+
+    bool parse(int argc, char **argv, Settings &settings)
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            const std::string option = argv[i];
+            if (i + 1 >= argc)
+                return false;
+            const std::string value = argv[++i];
+            if (option == "--width")
+                settings.width = std::atoi(value.c_str());
+            else if (option == "--height")
+                settings.height = std::atoi(value.c_str());
+            else if (option == "--seed")
+                settings.seed = std::strtoull(value.c_str(), nullptr, 10);
+            else if (option == "--cell-px")
+                settings.cellPx = std::atoi(value.c_str());
+            else if (option == "--output")
+                settings.output = value;
+            else if (option == "--queue-frames")
+                settings.queueFrames = std::atol(value.c_str());
+            else if (option == "--max-ticks")
+                settings.maxTicks = std::atol(value.c_str());
+            else if (option == "--policy" && (value == "bfs" || value == "cycle"))
+                settings.policy = value == "bfs" ? SnakeAutopilot::SHORTEST_PATH : SnakeAutopilot::HAMILTONIAN_CYCLE;
+            else if (option == "--format" && (value == "rgb" || value == "y4m"))
+                settings.format = value == "rgb" ? Format::RGB : Format::Y4M;
+            else
+                return false;
+        }
+        return settings.width >= SnakeGameplaySystem::MIN_SCENE_WIDTH && settings.height >= 1 && settings.cellPx >= 1 && settings.queueFrames >= 1L;
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Settings settings;
+    if (!parse(argc, argv, settings))
+    {
+        std::cerr << "usage: snake_video [--width W] [--height H] [--seed S] [--policy bfs|cycle] [--cell-px P]"
+                  << " [--format rgb|y4m] [--output FILE|-] [--queue-frames Q] [--max-ticks M]" << std::endl;
+        return 1;
+    }
+
+    const int frameWidth = settings.width * settings.cellPx;
+    const int frameHeight = settings.height * settings.cellPx;
+    SDL_Surface *surface = SDL_CreateSurface(frameWidth, frameHeight, SDL_PIXELFORMAT_XRGB8888);
+    if (surface == nullptr)
+    {
+        std::cerr << "SDL_CreateSurface error: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+    SDL_Renderer *renderer = SDL_CreateSoftwareRenderer(surface);
+    if (renderer == nullptr)
+    {
+        std::cerr << "SDL_CreateSoftwareRenderer error: " << SDL_GetError() << std::endl;
+        SDL_DestroySurface(surface);
+        return 1;
+    }
+    std::FILE *file = settings.output == "-" ? stdout : std::fopen(settings.output.c_str(), "wb");
+    if (file == nullptr)
+    {
+        std::cerr << "cannot open " << settings.output << std::endl;
+        SDL_DestroyRenderer(renderer);
+        SDL_DestroySurface(surface);
+        return 1;
+    }
+    if (settings.format == Format::Y4M)
+        std::fprintf(file, "YUV4MPEG2 W%d H%d F%llu:1 Ip A1:1 C444\n", frameWidth, frameHeight, static_cast<unsigned long long>(1000U / TICK_PERIOD_MS));
+
+    FrameQueue queue(static_cast<size_t>(settings.queueFrames));
+    bool isWriteFailed = false;
+    std::thread writer(write_frames, std::ref(queue), file, settings.format, frameWidth, frameHeight, &isWriteFailed);
+
+    entt::registry reg;
+    const entt::entity head = SnakeGameplaySystem::spawn_scene(reg, settings.width, settings.height, settings.seed, TICK_PERIOD_MS, SPEED, 1.0f);
+    reg.emplace<SnakeAutopilot>(head, settings.policy);
+    SnakeGameplaySystem::init(reg);
+    const long area = static_cast<long>(settings.width) * settings.height;
+    const long maxTicks = settings.maxTicks > 0L ? settings.maxTicks : 16L * area;
+    const size_t rowBytes = static_cast<size_t>(frameWidth) * sizeof(Uint32);
+    std::vector<SDL_FRect> rectsBySlot[8];
+    long frames = 0L;
+    bool isRendered = true;
+    for (long ticks = 0L; ticks <= maxTicks; ticks++)
+    {
+        isRendered = render_board(renderer, SnakeGameplaySystem::get_board_view(reg), static_cast<float>(settings.cellPx), rectsBySlot);
+        if (!isRendered)
+        {
+            std::cerr << "render error: " << SDL_GetError() << std::endl;
+            break;
+        }
+        std::vector<Uint32> frame = queue.get_free_frame();
+        frame.resize(static_cast<size_t>(frameWidth) * static_cast<size_t>(frameHeight));
+        for (int y = 0; y < frameHeight; y++)
+            std::memcpy(frame.data() + static_cast<size_t>(y) * frameWidth, static_cast<const Uint8 *>(surface->pixels) + y * surface->pitch, rowBytes);
+        queue.push(std::move(frame));
+        frames++;
+
+        if (SnakeGameplaySystem::get_status(reg) != SnakeGameplaySystem::GameStatus::PLAYING)
+            break;
+        AutopilotPipeline::iterate(reg);
+    }
+    queue.close();
+    writer.join();
+
+    std::cerr << frames << " frames, score " << SnakeGameplaySystem::get_score(reg) << std::endl;
+    if (file != stdout)
+        std::fclose(file);
+    else
+        std::fflush(stdout);
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroySurface(surface);
+    return isRendered && !isWriteFailed ? 0 : 1;
+}